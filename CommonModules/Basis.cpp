@@ -61,6 +61,18 @@ const Matrix4x4 &IBasis::GetMatrix() const
     return matrix;
 }
 
+const Matrix4x4 &IBasis::GetInvMatrix() const
+{
+    const Matrix4x4 &basisMatrix = GetMatrix();
+
+    if(needInvMatrixUpdate){
+        invMatrix = Matrix4x4::InverseRigid(basisMatrix);
+        needInvMatrixUpdate = false;
+    }
+
+    return invMatrix;
+}
+
 static void Rotate(const Vector3 &Axis, float Angle, Vector3 &Dir, Vector3 &Right, bool InverseCross)
 {
     Dir = Vector3::Normalize(Cast<Vector3>(Math::RotationAxis(Dir, Axis, Angle)));
@@ -73,10 +85,13 @@ static void Rotate(const Vector3 &Axis, float Angle, Vector3 &Dir, Vector3 &Righ
 
 void UVNBasis::SetDir(const Vector3 &NewDir)
 {
-    if(Dir() != NewDir)
+    //basis stays rigid, so its inverse is just a transposition
+    Vector3 newDir = Vector3::Normalize(NewDir);
+
+    if(Dir() != newDir)
         SetNeedUpdate();
 
-    Dir() = NewDir;
+    Dir() = newDir;
 }
 
 void UVNBasis::SetPos(const Point3F &NewPos)
@@ -14,14 +14,16 @@ namespace Camera
 
 void EyeCamera::SetDir(const Vector3 &Dir)
 {
-    if(Dir.x == 0.0f && Dir.z == 0.0f)
+    Vector3 dir = Vector3::Normalize(Dir);
+
+    if(dir.x == 0.0f && dir.z == 0.0f)
         angles.x = 0.0f;
     else
-        angles.x = Math::DirectionToAngle({Dir.x, Dir.z});
+        angles.x = Math::DirectionToAngle({dir.x, dir.z});
 
-    angles.y = acos(Dir.y) - Pi * 0.5f;
+    angles.y = acos(dir.y) - Pi * 0.5f;
 
-    UVNBasis::SetDir(Dir);
+    UVNBasis::SetDir(dir);
 }
 
 void EyeCamera::Invalidate(float Tf)
@@ -64,10 +66,4 @@ void EyeCamera::Invalidate(float Tf)
     }
 }
 
-const Matrix4x4 &EyeCamera::GetViewMatrix() const
-{
-    invertMatrix = Matrix4x4::Inverse(UVNBasis::GetMatrix());
-    return invertMatrix;
-}
-
 }
\ No newline at end of file
@@ -6,87 +6,271 @@
 *******************************************************************************/
 
 #include <Matrix4x4.h>
-#include <Matrix3x3.h>
 #include <Vector2.h>
+#include <assert.h>
+
+//kernels are chosen at compile time by target instruction set, MATRIX_NO_SIMD forces scalar code
+#ifndef MATRIX_NO_SIMD
+#if defined(__AVX__)
+#define MATRIX_AVX
+#endif
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define MATRIX_SSE
+#endif
+#endif
+
+#if defined(MATRIX_AVX)
+#include <immintrin.h>
+#elif defined(MATRIX_SSE)
+#include <xmmintrin.h>
+#endif
+
+#ifdef MATRIX_SSE
+
+//rows are vectors, so every row of a product is a sum of rows of B scaled by elements of a row of A
+static __m128 mul_row(__m128 Row, const float (&B)[4][4])
+{
+    __m128 out = _mm_mul_ps(_mm_shuffle_ps(Row, Row, 0x00), _mm_loadu_ps(B[0]));
+    out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(Row, Row, 0x55), _mm_loadu_ps(B[1])));
+    out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(Row, Row, 0xAA), _mm_loadu_ps(B[2])));
+    out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(Row, Row, 0xFF), _mm_loadu_ps(B[3])));
+    return out;
+}
 
-Matrix4x4::Matrix4x4():
-    a11(1.0f), a12(0.0f), a13(0.0f), a14(0.0f),
-    a21(0.0f), a22(1.0f), a23(0.0f), a24(0.0f),
-    a31(0.0f), a32(0.0f), a33(1.0f), a34(0.0f),
-    a41(0.0f), a42(0.0f), a43(0.0f), a44(1.0f)
-{}
-
-Matrix4x4::Matrix4x4(const Point4F &Part1, const Point4F &Part2, const Point4F &Part3, const Point4F &Part4, bool AsRows)
-{
-    if(AsRows){
-        a11 = Part1.x; a12 = Part1.y; a13 = Part1.z; a14 = Part1.w;
-        a21 = Part2.x; a22 = Part2.y; a23 = Part2.z; a24 = Part2.w;
-        a31 = Part3.x; a32 = Part3.y; a33 = Part3.z; a34 = Part3.w;
-        a41 = Part4.x; a42 = Part4.y; a43 = Part4.z; a44 = Part4.w;
-    }else{
-        a11 = Part1.x; a12 = Part2.x; a13 = Part3.x; a14 = Part4.x;
-        a21 = Part1.y; a22 = Part2.y; a23 = Part3.y; a24 = Part4.y;
-        a31 = Part1.z; a32 = Part2.z; a33 = Part3.z; a34 = Part4.z;
-        a41 = Part1.w; a42 = Part2.w; a43 = Part3.w; a44 = Part4.w;
-    }
+#endif
+
+#ifdef MATRIX_AVX
+
+//two rows of A in one register, rows of B are broadcasted to both halves
+static void mul_rows_pair(const float *Rows, const float (&B)[4][4], float *Out)
+{
+    __m256 rows = _mm256_loadu_ps(Rows);
+    __m256 out = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x00), _mm256_broadcast_ps((const __m128*)B[0]));
+    out = _mm256_add_ps(out, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x55), _mm256_broadcast_ps((const __m128*)B[1])));
+    out = _mm256_add_ps(out, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xAA), _mm256_broadcast_ps((const __m128*)B[2])));
+    out = _mm256_add_ps(out, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xFF), _mm256_broadcast_ps((const __m128*)B[3])));
+    _mm256_storeu_ps(Out, out);
 }
 
+#endif
+
 float Matrix4x4::Determinant() const
 {
-    Matrix3x3 a = {{a22,a23,a24}, {a32,a33,a34}, {a42,a43,a44}};
-    Matrix3x3 b = {{a21,a23,a24}, {a31,a33,a34}, {a41,a43,a44}};
-    Matrix3x3 c = {{a21,a22,a24}, {a31,a32,a34}, {a41,a42,a44}};
-    Matrix3x3 d = {{a21,a22,a23}, {a31,a32,a33}, {a41,a42,a43}};
+    //2x2 determinants of the upper and the lower rows pairs
+    float s0 = a11 * a22 - a21 * a12, s1 = a11 * a23 - a21 * a13, s2 = a11 * a24 - a21 * a14;
+    float s3 = a12 * a23 - a22 * a13, s4 = a12 * a24 - a22 * a14, s5 = a13 * a24 - a23 * a14;
+
+    float c0 = a31 * a42 - a41 * a32, c1 = a31 * a43 - a41 * a33, c2 = a31 * a44 - a41 * a34;
+    float c3 = a32 * a43 - a42 * a33, c4 = a32 * a44 - a42 * a34, c5 = a33 * a44 - a43 * a34;
 
-    return a11 * a.Determinant() - a12 * b.Determinant() + a13 * c.Determinant() - a14 * d.Determinant();
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 }
 
+#ifdef MATRIX_SSE
+
+//cofactors are computed on columns in registers, determinant comes from the first of them
 Matrix4x4 Matrix4x4::Inverse(const Matrix4x4 &M)
 {
-    Matrix4x4 mMinors;
-    mMinors.a11 = Matrix3x3({M.a22, M.a23, M.a24}, {M.a32, M.a33, M.a34}, {M.a42, M.a43, M.a44}).Determinant();
-    mMinors.a12 = Matrix3x3({M.a21, M.a23, M.a24}, {M.a31, M.a33, M.a34}, {M.a41, M.a43, M.a44}).Determinant();
-    mMinors.a13 = Matrix3x3({M.a21, M.a22, M.a24}, {M.a31, M.a32, M.a34}, {M.a41, M.a42, M.a44}).Determinant();
-    mMinors.a14 = Matrix3x3({M.a21, M.a22, M.a23}, {M.a31, M.a32, M.a33}, {M.a41, M.a42, M.a43}).Determinant();
-
-    mMinors.a21 = Matrix3x3({M.a12, M.a13, M.a14}, {M.a32, M.a33, M.a34}, {M.a42, M.a43, M.a44}).Determinant();
-    mMinors.a22 = Matrix3x3({M.a11, M.a13, M.a14}, {M.a31, M.a33, M.a34}, {M.a41, M.a43, M.a44}).Determinant();
-    mMinors.a23 = Matrix3x3({M.a11, M.a12, M.a14}, {M.a31, M.a32, M.a34}, {M.a41, M.a42, M.a44}).Determinant();
-    mMinors.a24 = Matrix3x3({M.a11, M.a12, M.a13}, {M.a31, M.a32, M.a33}, {M.a41, M.a42, M.a43}).Determinant();
-
-    mMinors.a31 = Matrix3x3({M.a12, M.a13, M.a14}, {M.a22, M.a23, M.a24}, {M.a42, M.a43, M.a44}).Determinant();
-    mMinors.a32 = Matrix3x3({M.a11, M.a13, M.a14}, {M.a21, M.a23, M.a24}, {M.a41, M.a43, M.a44}).Determinant();
-    mMinors.a33 = Matrix3x3({M.a11, M.a12, M.a14}, {M.a21, M.a22, M.a24}, {M.a41, M.a42, M.a44}).Determinant();
-    mMinors.a34 = Matrix3x3({M.a11, M.a12, M.a13}, {M.a21, M.a22, M.a23}, {M.a41, M.a42, M.a43}).Determinant();
-
-    mMinors.a41 = Matrix3x3({M.a12, M.a13, M.a14}, {M.a22, M.a23, M.a24}, {M.a32, M.a33, M.a34}).Determinant();
-    mMinors.a42 = Matrix3x3({M.a12, M.a13, M.a14}, {M.a21, M.a23, M.a24}, {M.a31, M.a33, M.a34}).Determinant();
-    mMinors.a43 = Matrix3x3({M.a11, M.a12, M.a14}, {M.a21, M.a22, M.a24}, {M.a31, M.a32, M.a34}).Determinant();
-    mMinors.a44 = Matrix3x3({M.a11, M.a12, M.a13}, {M.a21, M.a22, M.a23}, {M.a31, M.a32, M.a33}).Determinant();
-
-    Matrix4x4 mCofactors = mMinors;
-    mCofactors.a12 *= -1.0f;
-    mCofactors.a14 *= -1.0f;
-    mCofactors.a21 *= -1.0f;
-    mCofactors.a23 *= -1.0f;
-    mCofactors.a32 *= -1.0f;
-    mCofactors.a34 *= -1.0f;
-    mCofactors.a41 *= -1.0f;
-    mCofactors.a43 *= -1.0f;
-
-    Matrix4x4 mAdjoint = Transpose(mCofactors);
-    
-    return Mul(mAdjoint, 1.0f / M.Determinant());
+    __m128 row0 = _mm_loadu_ps(M.m[0]), row1 = _mm_loadu_ps(M.m[1]);
+    __m128 row2 = _mm_loadu_ps(M.m[2]), row3 = _mm_loadu_ps(M.m[3]);
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+    //second and fourth columns are used with swapped halves
+    row1 = _mm_shuffle_ps(row1, row1, 0x4E);
+    row3 = _mm_shuffle_ps(row3, row3, 0x4E);
+
+    __m128 minor0, minor1, minor2, minor3, tmp;
+
+    tmp = _mm_mul_ps(row2, row3);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+    minor0 = _mm_mul_ps(row1, tmp);
+    minor1 = _mm_mul_ps(row0, tmp);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+    minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp), minor0);
+    minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor1);
+    minor1 = _mm_shuffle_ps(minor1, minor1, 0x4E);
+
+    tmp = _mm_mul_ps(row1, row2);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+    minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor0);
+    minor3 = _mm_mul_ps(row0, tmp);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+    minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp));
+    minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor3);
+    minor3 = _mm_shuffle_ps(minor3, minor3, 0x4E);
+
+    tmp = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4E), row3);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+    row2 = _mm_shuffle_ps(row2, row2, 0x4E);
+    minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor0);
+    minor2 = _mm_mul_ps(row0, tmp);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+    minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp));
+    minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor2);
+    minor2 = _mm_shuffle_ps(minor2, minor2, 0x4E);
+
+    tmp = _mm_mul_ps(row0, row1);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+    minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor2);
+    minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp), minor3);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+    minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp), minor2);
+    minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp));
+
+    tmp = _mm_mul_ps(row0, row3);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+    minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp));
+    minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor2);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+    minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor1);
+    minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp));
+
+    tmp = _mm_mul_ps(row0, row2);
+    tmp = _mm_shuffle_ps(tmp, tmp, 0xB1);
+    minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor1);
+    minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp));
+    tmp = _mm_shuffle_ps(tmp, tmp, 0x4E);
+    minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp));
+    minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor3);
+
+    __m128 det = _mm_mul_ps(row0, minor0);
+    det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4E), det);
+    det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xB1), det);
+    det = _mm_div_ss(_mm_set_ss(1.0f), det);
+    det = _mm_shuffle_ps(det, det, 0x00);
+
+    Matrix4x4 mOut;
+    _mm_storeu_ps(mOut.m[0], _mm_mul_ps(det, minor0));
+    _mm_storeu_ps(mOut.m[1], _mm_mul_ps(det, minor1));
+    _mm_storeu_ps(mOut.m[2], _mm_mul_ps(det, minor2));
+    _mm_storeu_ps(mOut.m[3], _mm_mul_ps(det, minor3));
+
+    return mOut;
+}
+
+#else
+
+//adjoint from 2x2 determinants, they give the determinant too
+Matrix4x4 Matrix4x4::Inverse(const Matrix4x4 &M)
+{
+    float s0 = M.a11 * M.a22 - M.a21 * M.a12, s1 = M.a11 * M.a23 - M.a21 * M.a13, s2 = M.a11 * M.a24 - M.a21 * M.a14;
+    float s3 = M.a12 * M.a23 - M.a22 * M.a13, s4 = M.a12 * M.a24 - M.a22 * M.a14, s5 = M.a13 * M.a24 - M.a23 * M.a14;
+
+    float c0 = M.a31 * M.a42 - M.a41 * M.a32, c1 = M.a31 * M.a43 - M.a41 * M.a33, c2 = M.a31 * M.a44 - M.a41 * M.a34;
+    float c3 = M.a32 * M.a43 - M.a42 * M.a33, c4 = M.a32 * M.a44 - M.a42 * M.a34, c5 = M.a33 * M.a44 - M.a43 * M.a34;
+
+    float invDet = 1.0f / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+    Matrix4x4 mOut;
+
+    mOut.a11 = ( M.a22 * c5 - M.a23 * c4 + M.a24 * c3) * invDet;
+    mOut.a12 = (-M.a12 * c5 + M.a13 * c4 - M.a14 * c3) * invDet;
+    mOut.a13 = ( M.a42 * s5 - M.a43 * s4 + M.a44 * s3) * invDet;
+    mOut.a14 = (-M.a32 * s5 + M.a33 * s4 - M.a34 * s3) * invDet;
+
+    mOut.a21 = (-M.a21 * c5 + M.a23 * c2 - M.a24 * c1) * invDet;
+    mOut.a22 = ( M.a11 * c5 - M.a13 * c2 + M.a14 * c1) * invDet;
+    mOut.a23 = (-M.a41 * s5 + M.a43 * s2 - M.a44 * s1) * invDet;
+    mOut.a24 = ( M.a31 * s5 - M.a33 * s2 + M.a34 * s1) * invDet;
+
+    mOut.a31 = ( M.a21 * c4 - M.a22 * c2 + M.a24 * c0) * invDet;
+    mOut.a32 = (-M.a11 * c4 + M.a12 * c2 - M.a14 * c0) * invDet;
+    mOut.a33 = ( M.a41 * s4 - M.a42 * s2 + M.a44 * s0) * invDet;
+    mOut.a34 = (-M.a31 * s4 + M.a32 * s2 - M.a34 * s0) * invDet;
+
+    mOut.a41 = (-M.a21 * c3 + M.a22 * c1 - M.a23 * c0) * invDet;
+    mOut.a42 = ( M.a11 * c3 - M.a12 * c1 + M.a13 * c0) * invDet;
+    mOut.a43 = (-M.a41 * s3 + M.a42 * s1 - M.a43 * s0) * invDet;
+    mOut.a44 = ( M.a31 * s3 - M.a32 * s1 + M.a33 * s0) * invDet;
+
+    return mOut;
+}
+
+#endif
+
+bool Matrix4x4::IsAffine(float Epsilon) const
+{
+    return fabs(a14) <= Epsilon && fabs(a24) <= Epsilon && fabs(a34) <= Epsilon && fabs(a44 - 1.0f) <= Epsilon;
+}
+
+bool Matrix4x4::IsRigid(float Epsilon) const
+{
+    if(!IsAffine(Epsilon))
+        return false;
+
+    for(int32_t r = 0; r < 3; r++)
+        for(int32_t c = r; c < 3; c++){
+            float dot = m[r][0] * m[c][0] + m[r][1] * m[c][1] + m[r][2] * m[c][2];
+            if(fabs(dot - (r == c ? 1.0f : 0.0f)) > Epsilon)
+                return false;
+        }
+
+    return true;
+}
+
+//inverse of the rotation part is its adjoint, translation is moved back through it
+Matrix4x4 Matrix4x4::InverseAffine(const Matrix4x4 &M)
+{
+    assert(M.IsAffine() && "matrix is not affine");
+
+    float c11 = M.a22 * M.a33 - M.a23 * M.a32;
+    float c12 = M.a23 * M.a31 - M.a21 * M.a33;
+    float c13 = M.a21 * M.a32 - M.a22 * M.a31;
+
+    float invDet = 1.0f / (M.a11 * c11 + M.a12 * c12 + M.a13 * c13);
+
+    Matrix4x4 mOut;
+
+    mOut.a11 = c11 * invDet;
+    mOut.a12 = (M.a13 * M.a32 - M.a12 * M.a33) * invDet;
+    mOut.a13 = (M.a12 * M.a23 - M.a13 * M.a22) * invDet;
+
+    mOut.a21 = c12 * invDet;
+    mOut.a22 = (M.a11 * M.a33 - M.a13 * M.a31) * invDet;
+    mOut.a23 = (M.a13 * M.a21 - M.a11 * M.a23) * invDet;
+
+    mOut.a31 = c13 * invDet;
+    mOut.a32 = (M.a12 * M.a31 - M.a11 * M.a32) * invDet;
+    mOut.a33 = (M.a11 * M.a22 - M.a12 * M.a21) * invDet;
+
+    mOut.a41 = -(M.a41 * mOut.a11 + M.a42 * mOut.a21 + M.a43 * mOut.a31);
+    mOut.a42 = -(M.a41 * mOut.a12 + M.a42 * mOut.a22 + M.a43 * mOut.a32);
+    mOut.a43 = -(M.a41 * mOut.a13 + M.a42 * mOut.a23 + M.a43 * mOut.a33);
+
+    return mOut;
+}
+
+//inverse of the rotation part is its transpose
+Matrix4x4 Matrix4x4::InverseRigid(const Matrix4x4 &M)
+{
+    assert(M.IsRigid() && "matrix is not rigid");
+
+    Matrix4x4 mOut;
+
+    mOut.a11 = M.a11; mOut.a12 = M.a21; mOut.a13 = M.a31;
+    mOut.a21 = M.a12; mOut.a22 = M.a22; mOut.a23 = M.a32;
+    mOut.a31 = M.a13; mOut.a32 = M.a23; mOut.a33 = M.a33;
+
+    mOut.a41 = -(M.a41 * M.a11 + M.a42 * M.a12 + M.a43 * M.a13);
+    mOut.a42 = -(M.a41 * M.a21 + M.a42 * M.a22 + M.a43 * M.a23);
+    mOut.a43 = -(M.a41 * M.a31 + M.a42 * M.a32 + M.a43 * M.a33);
+
+    return mOut;
 }
 
 Matrix4x4 Matrix4x4::Add(const Matrix4x4 &A, const Matrix4x4 &B)
 {
     Matrix4x4 mOut;
 
+#ifdef MATRIX_SSE
+    for(int32_t r = 0; r < 4; r++)
+        _mm_storeu_ps(mOut.m[r], _mm_add_ps(_mm_loadu_ps(A.m[r]), _mm_loadu_ps(B.m[r])));
+#else
     mOut.a11 = A.a11 + B.a11; mOut.a12 = A.a12 + B.a12; mOut.a13 = A.a13 + B.a13; mOut.a14 = A.a14 + B.a14;
     mOut.a21 = A.a21 + B.a21; mOut.a22 = A.a22 + B.a22; mOut.a23 = A.a23 + B.a23; mOut.a24 = A.a24 + B.a24;
     mOut.a31 = A.a31 + B.a31; mOut.a32 = A.a32 + B.a32; mOut.a33 = A.a33 + B.a33; mOut.a34 = A.a34 + B.a34;
     mOut.a41 = A.a41 + B.a41; mOut.a42 = A.a42 + B.a42; mOut.a43 = A.a43 + B.a43; mOut.a44 = A.a44 + B.a44;
+#endif
 
     return mOut;
 }
@@ -95,24 +279,15 @@ Matrix4x4 Matrix4x4::Sub(const Matrix4x4 &A, const Matrix4x4 &B)
 {
     Matrix4x4 mOut;
 
+#ifdef MATRIX_SSE
+    for(int32_t r = 0; r < 4; r++)
+        _mm_storeu_ps(mOut.m[r], _mm_sub_ps(_mm_loadu_ps(A.m[r]), _mm_loadu_ps(B.m[r])));
+#else
     mOut.a11 = A.a11 - B.a11; mOut.a12 = A.a12 - B.a12; mOut.a13 = A.a13 - B.a13; mOut.a14 = A.a14 - B.a14;
     mOut.a21 = A.a21 - B.a21; mOut.a22 = A.a22 - B.a22; mOut.a23 = A.a23 - B.a23; mOut.a24 = A.a24 - B.a24;
     mOut.a31 = A.a31 - B.a31; mOut.a32 = A.a32 - B.a32; mOut.a33 = A.a33 - B.a33; mOut.a34 = A.a34 - B.a34;
     mOut.a41 = A.a41 - B.a41; mOut.a42 = A.a42 - B.a42; mOut.a43 = A.a43 - B.a43; mOut.a44 = A.a44 - B.a44;
-
-    return mOut;
-}
-
-Matrix4x4 Matrix4x4::Transpose(const Matrix4x4 &Matrix)
-{
-    Matrix4x4 mOut = Matrix;
-
-    std::swap(mOut.a21, mOut.a12);
-    std::swap(mOut.a31, mOut.a13);
-    std::swap(mOut.a41, mOut.a14);
-    std::swap(mOut.a32, mOut.a23);
-    std::swap(mOut.a42, mOut.a24);
-    std::swap(mOut.a43, mOut.a34);
+#endif
 
     return mOut;
 }
@@ -121,10 +296,16 @@ Matrix4x4 Matrix4x4::Mul(const Matrix4x4 &Matrix, float Val)
 {
     Matrix4x4 mOut = Matrix;
 
+#ifdef MATRIX_SSE
+    __m128 val = _mm_set1_ps(Val);
+    for(int32_t r = 0; r < 4; r++)
+        _mm_storeu_ps(mOut.m[r], _mm_mul_ps(_mm_loadu_ps(mOut.m[r]), val));
+#else
     mOut.a11 *= Val; mOut.a12 *= Val; mOut.a13 *= Val; mOut.a14 *= Val;
     mOut.a21 *= Val; mOut.a22 *= Val; mOut.a23 *= Val; mOut.a24 *= Val;
     mOut.a31 *= Val; mOut.a32 *= Val; mOut.a33 *= Val; mOut.a34 *= Val;
     mOut.a41 *= Val; mOut.a42 *= Val; mOut.a43 *= Val; mOut.a44 *= Val;
+#endif
 
     return mOut;
 }
@@ -133,6 +314,13 @@ Matrix4x4 Matrix4x4::Mul(const Matrix4x4 &A, const Matrix4x4 &B)
 {
     Matrix4x4 mOut;
 
+#if defined(MATRIX_AVX)
+    mul_rows_pair(A.m[0], B.m, mOut.m[0]);
+    mul_rows_pair(A.m[2], B.m, mOut.m[2]);
+#elif defined(MATRIX_SSE)
+    for(int32_t r = 0; r < 4; r++)
+        _mm_storeu_ps(mOut.m[r], mul_row(_mm_loadu_ps(A.m[r]), B.m));
+#else
     mOut.a11 = A.a11 * B.a11 + A.a12 * B.a21 + A.a13 * B.a31 + A.a14 * B.a41;
     mOut.a12 = A.a11 * B.a12 + A.a12 * B.a22 + A.a13 * B.a32 + A.a14 * B.a42;
     mOut.a13 = A.a11 * B.a13 + A.a12 * B.a23 + A.a13 * B.a33 + A.a14 * B.a43;
@@ -152,6 +340,7 @@ Matrix4x4 Matrix4x4::Mul(const Matrix4x4 &A, const Matrix4x4 &B)
     mOut.a42 = A.a41 * B.a12 + A.a42 * B.a22 + A.a43 * B.a32 + A.a44 * B.a42;
     mOut.a43 = A.a41 * B.a13 + A.a42 * B.a23 + A.a43 * B.a33 + A.a44 * B.a43;
     mOut.a44 = A.a41 * B.a14 + A.a42 * B.a24 + A.a43 * B.a34 + A.a44 * B.a44;
+#endif
 
     return mOut;
 }
@@ -160,10 +349,14 @@ Vector4 Matrix4x4::Transform(const Vector4 &V) const
 {
     Vector4 vOut;
 
+#ifdef MATRIX_SSE
+    _mm_storeu_ps(&vOut.x, mul_row(_mm_loadu_ps(&V.x), m));
+#else
     vOut.x = a11 * V.x + a21 * V.y + a31 * V.z + a41 * V.w;
     vOut.y = a12 * V.x + a22 * V.y + a32 * V.z + a42 * V.w;
     vOut.z = a13 * V.x + a23 * V.y + a33 * V.z + a43 * V.w;
     vOut.w = a14 * V.x + a24 * V.y + a34 * V.z + a44 * V.w;
+#endif
 
     return vOut;
 }
@@ -199,35 +392,175 @@ Point3F Matrix4x4::Transform(const Matrix4x4 &Matrix, const Point3F &V, bool Dev
     return Matrix.Transform(V, DevideByW);
 }
 
-Matrix4x4 Matrix4x4::Translation(const Point3F &Pos)
+//W is 1 for points and 0 for vectors
+static void transform_element(const float (&M)[4][4], const float *V, float W, bool DevideByW, float *Out)
 {
-    Matrix4x4 mOut;
+    float x = V[0], y = V[1], z = V[2];
 
-    mOut.a41 = Pos.x;
-    mOut.a42 = Pos.y;
-    mOut.a43 = Pos.z;
+    float outX = x * M[0][0] + y * M[1][0] + z * M[2][0] + W * M[3][0];
+    float outY = x * M[0][1] + y * M[1][1] + z * M[2][1] + W * M[3][1];
+    float outZ = x * M[0][2] + y * M[1][2] + z * M[2][2] + W * M[3][2];
 
-    return mOut;
+    if(DevideByW){
+        float invW = 1.0f / (x * M[0][3] + y * M[1][3] + z * M[2][3] + W * M[3][3]);
+        outX *= invW;
+        outY *= invW;
+        outZ *= invW;
+    }
+
+    Out[0] = outX;
+    Out[1] = outY;
+    Out[2] = outZ;
 }
 
-Matrix4x4 Matrix4x4::Scalling(float Factor)
+static void transform_strided(const float (&M)[4][4], const char *Data, size_t Stride, char *OutData, size_t OutStride, size_t Count, float W, bool DevideByW)
 {
-    Matrix4x4 mOut;
+#ifdef MATRIX_SSE
+    __m128 row0 = _mm_loadu_ps(M[0]), row1 = _mm_loadu_ps(M[1]), row2 = _mm_loadu_ps(M[2]);
+    __m128 row3 = _mm_mul_ps(_mm_loadu_ps(M[3]), _mm_set1_ps(W));
 
-    mOut.a11 = mOut.a22 = mOut.a33 = Factor;
+    for(size_t e = 0; e < Count; e++, Data += Stride, OutData += OutStride){
+        const float *v = reinterpret_cast<const float*>(Data);
 
-    return mOut;
+        __m128 out = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), row0), _mm_mul_ps(_mm_set1_ps(v[1]), row1));
+        out = _mm_add_ps(out, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[2]), row2), row3));
+
+        if(DevideByW)
+            out = _mm_div_ps(out, _mm_shuffle_ps(out, out, 0xFF));
+
+        //only three floats are stored, the next element may follow them
+        float *outV = reinterpret_cast<float*>(OutData);
+        _mm_storel_pi(reinterpret_cast<__m64*>(outV), out);
+        _mm_store_ss(outV + 2, _mm_movehl_ps(out, out));
+    }
+#else
+    for(size_t e = 0; e < Count; e++, Data += Stride, OutData += OutStride)
+        transform_element(M, reinterpret_cast<const float*>(Data), W, DevideByW, reinterpret_cast<float*>(OutData));
+#endif
 }
 
-Matrix4x4 Matrix4x4::Scalling(const Size3F &Size)
+#ifdef MATRIX_SSE
+
+struct SseLanes
 {
-    Matrix4x4 mOut;
+    typedef __m128 Register;
+    static const size_t WIDTH = 4;
+    static Register Set(float Val) {return _mm_set1_ps(Val);}
+    static Register Load(const float *Data) {return _mm_loadu_ps(Data);}
+    static void Store(float *Data, Register Val) {_mm_storeu_ps(Data, Val);}
+    static Register Add(Register A, Register B) {return _mm_add_ps(A, B);}
+    static Register Mul(Register A, Register B) {return _mm_mul_ps(A, B);}
+    static Register Div(Register A, Register B) {return _mm_div_ps(A, B);}
+};
 
-    mOut.a11 = Size.width;
-    mOut.a22 = Size.height;
-    mOut.a33 = Size.depth;
+#endif
 
-    return mOut;
+#ifdef MATRIX_AVX
+
+struct AvxLanes
+{
+    typedef __m256 Register;
+    static const size_t WIDTH = 8;
+    static Register Set(float Val) {return _mm256_set1_ps(Val);}
+    static Register Load(const float *Data) {return _mm256_loadu_ps(Data);}
+    static void Store(float *Data, Register Val) {_mm256_storeu_ps(Data, Val);}
+    static Register Add(Register A, Register B) {return _mm256_add_ps(A, B);}
+    static Register Mul(Register A, Register B) {return _mm256_mul_ps(A, B);}
+    static Register Div(Register A, Register B) {return _mm256_div_ps(A, B);}
+};
+
+#endif
+
+//one element per lane, returns count of transformed elements, the rest is left for scalar code
+template<class TLanes>
+static size_t transform_lanes(const float (&M)[4][4], const float *X, const float *Y, const float *Z, float *OutX, float *OutY, float *OutZ, size_t Count, float W, bool DevideByW)
+{
+    typedef typename TLanes::Register Register;
+
+    Register m[4][4];
+    for(int32_t r = 0; r < 4; r++)
+        for(int32_t c = 0; c < 4; c++)
+            m[r][c] = TLanes::Set(r == 3 ? M[r][c] * W : M[r][c]);
+
+    size_t e = 0;
+    for(; e + TLanes::WIDTH <= Count; e += TLanes::WIDTH){
+        Register x = TLanes::Load(X + e), y = TLanes::Load(Y + e), z = TLanes::Load(Z + e);
+
+        Register out[4];
+        for(int32_t c = 0; c < (DevideByW ? 4 : 3); c++)
+            out[c] = TLanes::Add(TLanes::Add(TLanes::Mul(x, m[0][c]), TLanes::Mul(y, m[1][c])),
+                                 TLanes::Add(TLanes::Mul(z, m[2][c]), m[3][c]));
+
+        if(DevideByW)
+            for(int32_t c = 0; c < 3; c++)
+                out[c] = TLanes::Div(out[c], out[3]);
+
+        TLanes::Store(OutX + e, out[0]);
+        TLanes::Store(OutY + e, out[1]);
+        TLanes::Store(OutZ + e, out[2]);
+    }
+
+    return e;
+}
+
+static void transform_streams(const float (&M)[4][4], const float *X, const float *Y, const float *Z, float *OutX, float *OutY, float *OutZ, size_t Count, float W, bool DevideByW)
+{
+    size_t e = 0;
+
+#if defined(MATRIX_AVX)
+    e = transform_lanes<AvxLanes>(M, X, Y, Z, OutX, OutY, OutZ, Count, W, DevideByW);
+#elif defined(MATRIX_SSE)
+    e = transform_lanes<SseLanes>(M, X, Y, Z, OutX, OutY, OutZ, Count, W, DevideByW);
+#endif
+
+    for(; e < Count; e++){
+        float v[3] = {X[e], Y[e], Z[e]}, out[3];
+        transform_element(M, v, W, DevideByW, out);
+        OutX[e] = out[0];
+        OutY[e] = out[1];
+        OutZ[e] = out[2];
+    }
+}
+
+void Matrix4x4::TransformPoints(const Matrix4x4 &Matrix, const Point3F *Points, Point3F *OutPoints, size_t Count, bool DevideByW)
+{
+    transform_strided(Matrix.m, reinterpret_cast<const char*>(Points), sizeof(Point3F), reinterpret_cast<char*>(OutPoints), sizeof(Point3F), Count, 1.0f, DevideByW);
+}
+
+void Matrix4x4::TransformPoints(const Matrix4x4 &Matrix, const void *Points, size_t Stride, void *OutPoints, size_t OutStride, size_t Count, bool DevideByW)
+{
+    transform_strided(Matrix.m, static_cast<const char*>(Points), Stride, static_cast<char*>(OutPoints), OutStride, Count, 1.0f, DevideByW);
+}
+
+void Matrix4x4::TransformPoints(const Matrix4x4 &Matrix, const float *X, const float *Y, const float *Z, float *OutX, float *OutY, float *OutZ, size_t Count, bool DevideByW)
+{
+    transform_streams(Matrix.m, X, Y, Z, OutX, OutY, OutZ, Count, 1.0f, DevideByW);
+}
+
+void Matrix4x4::TransformVectors(const Matrix4x4 &Matrix, const Vector3 *Vectors, Vector3 *OutVectors, size_t Count)
+{
+    transform_strided(Matrix.m, reinterpret_cast<const char*>(Vectors), sizeof(Vector3), reinterpret_cast<char*>(OutVectors), sizeof(Vector3), Count, 0.0f, false);
+}
+
+void Matrix4x4::TransformVectors(const Matrix4x4 &Matrix, const void *Vectors, size_t Stride, void *OutVectors, size_t OutStride, size_t Count)
+{
+    transform_strided(Matrix.m, static_cast<const char*>(Vectors), Stride, static_cast<char*>(OutVectors), OutStride, Count, 0.0f, false);
+}
+
+void Matrix4x4::TransformVectors(const Matrix4x4 &Matrix, const float *X, const float *Y, const float *Z, float *OutX, float *OutY, float *OutZ, size_t Count)
+{
+    transform_streams(Matrix.m, X, Y, Z, OutX, OutY, OutZ, Count, 0.0f, false);
+}
+
+void Matrix4x4::Transform(const Matrix4x4 &Matrix, const Vector4 *Vectors, Vector4 *OutVectors, size_t Count)
+{
+#ifdef MATRIX_SSE
+    for(size_t e = 0; e < Count; e++)
+        _mm_storeu_ps(&OutVectors[e].x, mul_row(_mm_loadu_ps(&Vectors[e].x), Matrix.m));
+#else
+    for(size_t e = 0; e < Count; e++)
+        OutVectors[e] = Matrix.Transform(Vectors[e]);
+#endif
 }
 
 Matrix4x4 Matrix4x4::RotationX(float Angle)
@@ -425,6 +758,11 @@ Matrix4x4 Matrix4x4::RotationAxis(const Vector3 &Axis, float Angle)
 {
     Matrix4x4 mVecProj = VectorProjection(Axis);
 
-    return (Matrix4x4() - mVecProj) * cosf(Angle) +
-           VectorCrossProduct(Axis) * sinf(Angle) + mVecProj;
+    Matrix4x4 mOut = (Matrix4x4() - mVecProj) * cosf(Angle) +
+                     VectorCrossProduct(Axis) * sinf(Angle) + mVecProj;
+
+    //corner of the cross product matrix is scaled by sine too, it is not a part of the rotation
+    mOut(3, 3) = 1.0f;
+
+    return mOut;
 }
@@ -0,0 +1,165 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <Quaternion.h>
+#include <math.h>
+
+Quaternion Quaternion::Inverse(const Quaternion &Q)
+{
+    float invLenSq = 1.0f / Dot(Q, Q);
+
+    return Quaternion(-Q.x * invLenSq, -Q.y * invLenSq, -Q.z * invLenSq, Q.w * invLenSq);
+}
+
+Quaternion Quaternion::Normalize(const Quaternion &Q)
+{
+    float len = Q.Lenght();
+
+    if(len == 0.0f)
+        return Quaternion();
+
+    float invLen = 1.0f / len;
+
+    return Quaternion(Q.x * invLen, Q.y * invLen, Q.z * invLen, Q.w * invLen);
+}
+
+Quaternion Quaternion::RotationAxis(const Vector3 &Axis, float Angle)
+{
+    Vector3 axis = Vector3::Normalize(Axis);
+    float s = sinf(Angle * 0.5f);
+
+    return Quaternion(axis.x * s, axis.y * s, axis.z * s, cosf(Angle * 0.5f));
+}
+
+Quaternion Quaternion::RotationYawPitchRoll(const Vector3 &Rotation)
+{
+    return RotationYawPitchRoll(Rotation.y, Rotation.x, Rotation.z);
+}
+
+//roll around z, then pitch around x, then yaw around y
+Quaternion Quaternion::RotationYawPitchRoll(float Yaw, float Pitch, float Roll)
+{
+    float sRoll = sinf(Roll * 0.5f), cRoll = cosf(Roll * 0.5f);
+    float sPitch = sinf(Pitch * 0.5f), cPitch = cosf(Pitch * 0.5f);
+    float sYaw = sinf(Yaw * 0.5f), cYaw = cosf(Yaw * 0.5f);
+
+    return Quaternion(cYaw * sPitch * cRoll + sYaw * cPitch * sRoll,
+                      sYaw * cPitch * cRoll - cYaw * sPitch * sRoll,
+                      cYaw * cPitch * sRoll - sYaw * sPitch * cRoll,
+                      cYaw * cPitch * cRoll + sYaw * sPitch * sRoll);
+}
+
+//angles are taken from the elements of the rotation matrix, roll is zero in gimbal lock
+Vector3 Quaternion::ToYawPitchRoll(const Quaternion &Q)
+{
+    float sPitch = -2.0f * (Q.y * Q.z - Q.x * Q.w);
+
+    if(fabs(sPitch) >= 0.9999f){
+        float pitch = sPitch > 0.0f ? Pi * 0.5f : -Pi * 0.5f;
+        float yaw = atan2f(-2.0f * (Q.x * Q.z - Q.y * Q.w), 1.0f - 2.0f * (Q.y * Q.y + Q.z * Q.z));
+        return Vector3(pitch, yaw, 0.0f);
+    }
+
+    float pitch = asinf(sPitch);
+    float yaw = atan2f(2.0f * (Q.x * Q.z + Q.y * Q.w), 1.0f - 2.0f * (Q.x * Q.x + Q.y * Q.y));
+    float roll = atan2f(2.0f * (Q.x * Q.y + Q.z * Q.w), 1.0f - 2.0f * (Q.x * Q.x + Q.z * Q.z));
+
+    return Vector3(pitch, yaw, roll);
+}
+
+//the largest of the diagonal terms is taken as the divider, so it is never close to zero
+Quaternion Quaternion::FromMatrix(const Matrix4x4 &M)
+{
+    float trace = M(0, 0) + M(1, 1) + M(2, 2);
+
+    Quaternion qOut;
+
+    if(trace > 0.0f){
+        float s = sqrtf(trace + 1.0f) * 2.0f;
+        qOut = Quaternion((M(1, 2) - M(2, 1)) / s, (M(2, 0) - M(0, 2)) / s, (M(0, 1) - M(1, 0)) / s, 0.25f * s);
+    }else if(M(0, 0) > M(1, 1) && M(0, 0) > M(2, 2)){
+        float s = sqrtf(1.0f + M(0, 0) - M(1, 1) - M(2, 2)) * 2.0f;
+        qOut = Quaternion(0.25f * s, (M(0, 1) + M(1, 0)) / s, (M(2, 0) + M(0, 2)) / s, (M(1, 2) - M(2, 1)) / s);
+    }else if(M(1, 1) > M(2, 2)){
+        float s = sqrtf(1.0f + M(1, 1) - M(0, 0) - M(2, 2)) * 2.0f;
+        qOut = Quaternion((M(0, 1) + M(1, 0)) / s, 0.25f * s, (M(1, 2) + M(2, 1)) / s, (M(2, 0) - M(0, 2)) / s);
+    }else{
+        float s = sqrtf(1.0f + M(2, 2) - M(0, 0) - M(1, 1)) * 2.0f;
+        qOut = Quaternion((M(2, 0) + M(0, 2)) / s, (M(1, 2) + M(2, 1)) / s, 0.25f * s, (M(0, 1) - M(1, 0)) / s);
+    }
+
+    return Normalize(qOut);
+}
+
+Matrix4x4 Quaternion::ToMatrix(const Quaternion &Q)
+{
+    return ToMatrix(Q, Size3F(1.0f, 1.0f, 1.0f), Point3F(0.0f, 0.0f, 0.0f));
+}
+
+//rows of the rotation are scaled, translation is the last row, so no matrices are multiplied
+Matrix4x4 Quaternion::ToMatrix(const Quaternion &Q, const Size3F &Scalling, const Point3F &Pos)
+{
+    float xx = Q.x * Q.x, yy = Q.y * Q.y, zz = Q.z * Q.z;
+    float xy = Q.x * Q.y, xz = Q.x * Q.z, yz = Q.y * Q.z;
+    float xw = Q.x * Q.w, yw = Q.y * Q.w, zw = Q.z * Q.w;
+
+    float sx = Scalling.width, sy = Scalling.height, sz = Scalling.depth;
+
+    return Matrix4x4(sx * (1.0f - 2.0f * (yy + zz)), sx * 2.0f * (xy + zw), sx * 2.0f * (xz - yw), 0.0f,
+                     sy * 2.0f * (xy - zw), sy * (1.0f - 2.0f * (xx + zz)), sy * 2.0f * (yz + xw), 0.0f,
+                     sz * 2.0f * (xz + yw), sz * 2.0f * (yz - xw), sz * (1.0f - 2.0f * (xx + yy)), 0.0f,
+                     Pos.x, Pos.y, Pos.z, 1.0f);
+}
+
+Quaternion Quaternion::Slerp(const Quaternion &A, const Quaternion &B, float Factor)
+{
+    float cosAngle = Dot(A, B);
+    float sign = 1.0f;
+
+    if(cosAngle < 0.0f){
+        cosAngle = -cosAngle;
+        sign = -1.0f;
+    }
+
+    //sine of the angle goes to zero, linear interpolation is exact enough there
+    if(cosAngle > 0.9995f)
+        return Nlerp(A, B, Factor);
+
+    float angle = acosf(cosAngle);
+    float invSin = 1.0f / sinf(angle);
+    float fa = sinf((1.0f - Factor) * angle) * invSin;
+    float fb = sinf(Factor * angle) * invSin * sign;
+
+    return Quaternion(A.x * fa + B.x * fb, A.y * fa + B.y * fb, A.z * fa + B.z * fb, A.w * fa + B.w * fb);
+}
+
+Quaternion Quaternion::Nlerp(const Quaternion &A, const Quaternion &B, float Factor)
+{
+    float fa = 1.0f - Factor;
+    float fb = Dot(A, B) < 0.0f ? -Factor : Factor;
+
+    return Normalize(Quaternion(A.x * fa + B.x * fb, A.y * fa + B.y * fb, A.z * fa + B.z * fb, A.w * fa + B.w * fb));
+}
+
+//v + 2w(u x v) + 2u x (u x v) with u as the vector part, without the matrix
+Vector3 Quaternion::Rotate(const Quaternion &Q, const Vector3 &V)
+{
+    Vector3 u(Q.x, Q.y, Q.z);
+    Vector3 t = Vector3::Cross(u, V) * 2.0f;
+
+    return V + t * Q.w + Vector3::Cross(u, t);
+}
+
+void Quaternion::RotateVectors(const Quaternion &Q, const Vector3 *Vectors, Vector3 *OutVectors, size_t Count)
+{
+    Matrix4x4::TransformVectors(ToMatrix(Q), Vectors, OutVectors, Count);
+}
+
+void Quaternion::RotateVectors(const Quaternion &Q, const float *X, const float *Y, const float *Z, float *OutX, float *OutY, float *OutZ, size_t Count)
+{
+    Matrix4x4::TransformVectors(ToMatrix(Q), X, Y, Z, OutX, OutY, OutZ, Count);
+}
\ No newline at end of file
@@ -259,4 +259,15 @@ void Object3D::CalculateMatrix()
     WorldMatrix() = mScl * mRot * mTrans;
 }
 
+QuaternionObject3D::QuaternionObject3D() : GenericObject<Point3F, Size3F, Quaternion>()
+{
+    Scalling() = {1.0f, 1.0f, 1.0f};
+    Pos() = {0.0f, 0.0f, 0.0f};
+}
+
+void QuaternionObject3D::CalculateMatrix()
+{
+    WorldMatrix() = Quaternion::ToMatrix(GetRotation(), GetScalling(), GetPos());
+}
+
 }
\ No newline at end of file
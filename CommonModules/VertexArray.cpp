@@ -13,6 +13,7 @@
 #include <numeric>
 #include <stdint.h>
 #include <Meshes.h>
+#include <Matrix4x4.h>
 
 namespace Utils
 {
@@ -126,6 +127,28 @@ void VertexArray::ChangeCount(UINT NewCount)
     verticesCount = NewCount;
 }
 
+void VertexArray::TransformPoints(const std::string &SemanticName, const Matrix4x4 &Matrix, bool DevideByW) throw (Exception)
+{
+    const Element &elem = Utils::Find(vertexElements, SemanticName, SemanticNotFoundException(SemanticName + " semantic not found"));
+
+    if(elem.size < sizeof(Point3F))
+        throw InvalidSemanticTypeException(SemanticName + " semantic is not a point");
+
+    if(verticesCount)
+        Matrix4x4::TransformPoints(Matrix, &rawData[elem.offset], vertexSize, &rawData[elem.offset], vertexSize, verticesCount, DevideByW);
+}
+
+void VertexArray::TransformVectors(const std::string &SemanticName, const Matrix4x4 &Matrix) throw (Exception)
+{
+    const Element &elem = Utils::Find(vertexElements, SemanticName, SemanticNotFoundException(SemanticName + " semantic not found"));
+
+    if(elem.size < sizeof(Vector3))
+        throw InvalidSemanticTypeException(SemanticName + " semantic is not a vector");
+
+    if(verticesCount)
+        Matrix4x4::TransformVectors(Matrix, &rawData[elem.offset], vertexSize, &rawData[elem.offset], vertexSize, verticesCount);
+}
+
 }
 
 }
\ No newline at end of file
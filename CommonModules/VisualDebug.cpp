@@ -100,7 +100,7 @@ void Points3DContainer::Draw(const Camera::ICamera &Camera)
 {
     Matrix4x4 viewProg = Camera.GetViewMatrix() * Camera.GetProjMatrix();
 
-    shaders.gs.UpdateVariable("invView", Matrix4x4::Inverse(Camera.GetViewMatrix()));
+    shaders.gs.UpdateVariable("invView", Camera.GetInvViewMatrix());
     shaders.gs.UpdateVariable("viewProg", viewProg);
     shaders.gs.UpdateVariable("eyePosW", Vector4(Camera.GetPos(), 1.0f));
 
@@ -11,6 +11,12 @@
 #include <WindowsX.h>
 #include <ctime>
 
+static MATH_CONST Vector2 AREA_EDGES_NORMALS[] = {
+    {1.0f, 0.0f},//left
+    {0.0f, -1.0f},//right
+    {-1.0f, 0.0f},//bottom
+    {0.0f, 1.0f},//top
+};
 
 void Application::CheckEdgesCollision()
 {
@@ -28,24 +34,24 @@ void Application::CheckEdgesCollision()
 
         if(pos.x - radius <= 0){
 
-            norm = areaEdgesNormals[0];
+            norm = AREA_EDGES_NORMALS[0];
 
             newPos.x = radius;
 
         }else if(pos.x + radius >= CommonParams::GetScreenWidth()){
 
-            norm = areaEdgesNormals[2];
+            norm = AREA_EDGES_NORMALS[2];
 
             newPos.x = CommonParams::GetScreenWidth() - radius;
 
         }else if(pos.y - radius <= 0){
 
-            norm = areaEdgesNormals[3];
+            norm = AREA_EDGES_NORMALS[3];
 
             newPos.y = radius;
 
         }else{
-            norm = areaEdgesNormals[1];
+            norm = AREA_EDGES_NORMALS[1];
 
             newPos.y = CommonParams::GetScreenHeight() - radius;
         }
@@ -158,20 +164,13 @@ void Application::Init(HWND Wnd)
 
     timer.Init(60);
 
-    srand(time(nullptr));
+    Utils::SetRandomSeed((uint64_t)time(nullptr));
 
     circleDir = Vector2::Normalize({Math::Rand(-1.0f, 1.0f), Math::Rand(-1.0f, 1.0f)});
 
     mainCircle.SetPos({CommonParams::GetScreenWidth() * 0.5f, CommonParams::GetScreenHeight() * 0.5f});
     mainCircle.SetRadius(10.0f);
     mainCircle.SetColor({255, 0, 0, 0});
-
-    areaEdgesNormals = {
-        {1.0f, 0.0f},//left
-        {0.0f, -1.0f},//right
-        {-1.0f, 0.0f},//bottom
-        {0.0f, 1.0f},//top
-    };
 }
 
 void Application::Invalidate()
@@ -21,7 +21,6 @@ private:
     Time::Timer timer;
     HWND wnd = nullptr;
     bool lButtonDown = false;
-    std::vector<Vector2> areaEdgesNormals;
     void CheckEdgesCollision();
     void CheckObstaclesCollision();
     void Draw(HWND Hwnd);
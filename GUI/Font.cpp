@@ -10,7 +10,7 @@
 #include <Utils/Algorithm.h>
 #include <Utils/FileGuard.h>
 #include <CommonParams.h>
-#include <Xml.h>
+#include <XmlSchema.h>
 #include <Texture.h>
 
 namespace GUI
@@ -25,23 +25,49 @@ enum BlocksIds
     BLK_KERNINGS = 5
 };
 
+struct CharRecord
+{
+    int id;
+    float x, y, width, height, xOffset, yOffset, xAdvance;
+};
+
+struct KerningRecord
+{
+    int first, second, amount;
+};
+
+const auto CHAR_SCHEMA = XML::Schema<CharRecord>()
+    .Field<IntParser>("id", &CharRecord::id)
+    .Field<FloatParser>("x", &CharRecord::x)
+    .Field<FloatParser>("y", &CharRecord::y)
+    .Field<FloatParser>("width", &CharRecord::width)
+    .Field<FloatParser>("height", &CharRecord::height)
+    .Field<FloatParser>("xoffset", &CharRecord::xOffset)
+    .Field<FloatParser>("yoffset", &CharRecord::yOffset)
+    .Field<FloatParser>("xadvance", &CharRecord::xAdvance);
+
+const auto KERNING_SCHEMA = XML::Schema<KerningRecord>()
+    .Field<IntParser>("first", &KerningRecord::first)
+    .Field<IntParser>("second", &KerningRecord::second)
+    .Field<IntParser>("amount", &KerningRecord::amount);
+
 void Font::LoadFromXML(const std::string &FontDescriptionFilePath) throw (Exception)
 {
-    XML::XmlData xmlFile;
-    xmlFile.LoadFromFile(FontDescriptionFilePath);
+    XML::XmlData xmlFile(XML::XmlData::STORAGE_MODE_ARENA);
+    xmlFile.LoadFromFile(FontDescriptionFilePath, XML::LOAD_MODE_PARALLEL);
     
     const XML::Node &fontNode = xmlFile.GetRoot();
     const XML::Node &commonNode = fontNode.GetNode("common");
 
     name = fontNode.GetNode("info").GetProperty("face");
 
-    lineHeight = atoi(commonNode.GetProperty("lineHeight").c_str());
+    lineHeight = commonNode.GetInt("lineHeight");
     lineScreenHeight = (float)lineHeight / CommonParams::GetScreenHeight();
 
-    float texWidth = std::stof(commonNode.GetProperty("scaleW"));
-    float texHeight = std::stof(commonNode.GetProperty("scaleH"));
+    float texWidth = commonNode.GetFloat("scaleW");
+    float texHeight = commonNode.GetFloat("scaleH");
 
-    INT pagesCnt = atoi(commonNode.GetProperty("pages").c_str());
+    INT pagesCnt = commonNode.GetInt("pages");
     if(pagesCnt != 1)
         throw FontException("only one page in font supported");
 
@@ -49,54 +75,29 @@ void Font::LoadFromXML(const std::string &FontDescriptionFilePath) throw (Except
 
     texture = Texture::LoadTexture2DFromFile("../Resources/Textures/" + texFileName);
 
-    const XML::Node &chars = xmlFile.GetRoot().GetNode("chars");
-
-    size_t charsCnt = chars.GetNodesCount("char");
-
-    for(size_t i = 0; i < charsCnt; i++){
-        const XML::Node &charNode = chars.GetNode("char", i);
-
-        wchar_t ch = (wchar_t)atoi(charNode.GetProperty("id").c_str());
+    std::vector<CharRecord> chars;
+    CHAR_SCHEMA.ReadAll(xmlFile, fontNode.GetNode("chars"), "char", chars);
 
-        float x = std::stof(charNode.GetProperty("x"));
-        float y = std::stof(charNode.GetProperty("y"));
-
-        float width = std::stof(charNode.GetProperty("width"));
-        float height = std::stof(charNode.GetProperty("height"));
-
-        float offsetX = std::stof(charNode.GetProperty("xoffset"));
-        float offsetY = std::stof(charNode.GetProperty("yoffset"));
-
-        float xAnvance = std::stof(charNode.GetProperty("xadvance"));
-        
+    for(const CharRecord &charData : chars){
         Glyph newGlyph;
-        newGlyph.tcTopLeft.x = x / texWidth;
-        newGlyph.tcTopLeft.y = y / texHeight;
-        newGlyph.tcBottomRight.x = (x + width) / texWidth;
-        newGlyph.tcBottomRight.y = (y + height) / texHeight;
-        newGlyph.offset.x = offsetX;
-        newGlyph.offset.y = offsetY;
-        newGlyph.width = width;
-        newGlyph.height = height;
-        newGlyph.xAdvance = xAnvance;
-
-        glyphs.insert(std::make_pair(ch, newGlyph));
+        newGlyph.tcTopLeft.x = charData.x / texWidth;
+        newGlyph.tcTopLeft.y = charData.y / texHeight;
+        newGlyph.tcBottomRight.x = (charData.x + charData.width) / texWidth;
+        newGlyph.tcBottomRight.y = (charData.y + charData.height) / texHeight;
+        newGlyph.offset.x = charData.xOffset;
+        newGlyph.offset.y = charData.yOffset;
+        newGlyph.width = charData.width;
+        newGlyph.height = charData.height;
+        newGlyph.xAdvance = charData.xAdvance;
+
+        glyphs.insert(std::make_pair((wchar_t)charData.id, newGlyph));
     }
 
-    const XML::Node &kerningsNode = xmlFile.GetRoot().GetNode("kernings");
-
-    size_t kerningsCnt = kerningsNode.GetNodesCount("kerning");
+    std::vector<KerningRecord> kerningsData;
+    KERNING_SCHEMA.ReadAll(xmlFile, fontNode.GetNode("kernings"), "kerning", kerningsData);
 
-    for(size_t k = 0; k < kerningsCnt; k++){
-        const XML::Node &kerningNode = kerningsNode.GetNode("kerning", k);
-    
-        wchar_t first = (wchar_t)atoi(kerningNode.GetProperty("first").c_str());
-        wchar_t second = (wchar_t)atoi(kerningNode.GetProperty("second").c_str());
-
-        INT amount = atoi(kerningNode.GetProperty("amount").c_str());
-
-        kernings.insert(std::make_pair(Kerning(first, second), amount));
-    }
+    for(const KerningRecord &kerningData : kerningsData)
+        kernings.insert(std::make_pair(Kerning((wchar_t)kerningData.first, (wchar_t)kerningData.second), (INT)kerningData.amount));
 }
 
 void Font::LoadFromBinary(const std::string &FilePath) throw (Exception)
@@ -9,7 +9,7 @@
 #include <GUI/Control.h>
 #include <Utils/Algorithm.h>
 #include <CommonParams.h>
-#include <Xml.h>
+#include <XmlSchema.h>
 #include <sstream>
 #include <Serializing.h>
 
@@ -49,16 +49,44 @@ struct TextureData
 
 typedef std::map<std::string, TextureData> TexturesDataStorage;
 
+struct TextureRecord
+{
+    std::string name, fileName;
+    SizeF size;
+};
+
+struct ElementRecord
+{
+    std::string texture;
+    SizeF screenSize;
+    Point2F upperLeft;
+};
+
+const auto TEXTURE_SCHEMA = XML::Schema<TextureRecord>()
+    .Field<XML::PropertyParser>("name", &TextureRecord::name)
+    .Field<XML::PropertyParser>("fileName", &TextureRecord::fileName)
+    .Field<SizeFParser>("size", &TextureRecord::size);
+
+const auto ELEMENT_SCHEMA = XML::Schema<ElementRecord>()
+    .Field<XML::PropertyParser>("texture", &ElementRecord::texture)
+    .Field<SizeFParser>("screenSize", &ElementRecord::screenSize)
+    .Field<Point2FParser>("upperLeft", &ElementRecord::upperLeft);
+
+typedef decltype(ELEMENT_SCHEMA) ElementSchema;
+
 template<class TElement>
-TElement ParseElement(const XML::Node &DataNode, const TexturesDataStorage &TexturesData, Cursor &cursor)
+TElement ParseElement(const XML::Node &DataNode, const ElementSchema::Names &ElementNames, const TexturesDataStorage &TexturesData, Cursor &cursor)
 {
-    const std::string &texName = DataNode.GetProperty("texture");
+    ElementRecord elementData;
+    ELEMENT_SCHEMA.Read(DataNode, ElementNames, elementData);
+
+    const std::string &texName = elementData.texture;
 
     const TextureData &texData = Utils::Find(TexturesData, texName, cursor.CreateException(texName + " texture not declared"));
 
-    SizeF screenSize = SizeFParser::FromString(DataNode.GetProperty("screenSize"));
+    const SizeF &screenSize = elementData.screenSize;
 
-    Point2F upperLeftPos = Point2FParser::FromString(DataNode.GetProperty("upperLeft"));
+    const Point2F &upperLeftPos = elementData.upperLeft;
     Point2F lowerRightPos = (upperLeftPos + Cast<Point2F>(screenSize));
 
     TElement newElement;
@@ -164,25 +192,30 @@ void Theme::Load(const std::string &Name) throw (Exception)
 
     cursor.SetThemeName(Name);
 
-    XML::XmlData data;
-    data.LoadFromFile("../Resources/GuiThemes/" + Name);
+    XML::XmlData data(XML::XmlData::STORAGE_MODE_ARENA);
+    data.LoadFromFile("../Resources/GuiThemes/" + Name, XML::LOAD_MODE_MAPPED);
 
     const XML::Node &guiNode = data.GetRoot();
     
     const XML::Node &texturesNode = guiNode.GetNode("textures");
 
+    auto textureNames = TEXTURE_SCHEMA.Bind(data);
+
     for(const XML::Node &textureNode : texturesNode){
 
-        SizeF texSize = SizeFParser::FromString(textureNode.GetProperty("size"));
+        TextureRecord textureData;
+        TEXTURE_SCHEMA.Read(textureNode, textureNames, textureData);
 
         TextureData newTexData;
-        newTexData.widthOverOne = 1.0f / texSize.width;
-        newTexData.heightOverOne = 1.0f / texSize.height;
-        newTexData.fileName = textureNode.GetProperty("fileName");
+        newTexData.widthOverOne = 1.0f / textureData.size.width;
+        newTexData.heightOverOne = 1.0f / textureData.size.height;
+        newTexData.fileName = textureData.fileName;
 
-        texturesData.insert({textureNode.GetProperty("name"), newTexData});
+        texturesData.insert({textureData.name, newTexData});
     }
 
+    ElementSchema::Names elementNames = ELEMENT_SCHEMA.Bind(data);
+
     const XML::Node &controlsNode = guiNode.GetNode("controls");
 
     for(const XML::NodesNamesData &controlNodesData : controlsNode.GetNodesNames()){
@@ -210,7 +243,7 @@ void Theme::Load(const std::string &Name) throw (Exception)
                     newControlView.params.insert({paramDataNode.GetName(), paramDataNode.GetValue()});
                 }
              }else
-                newControlView.elements.insert({dataNode.GetName(), ParseElement<ControlView::ElementData>(dataNode, texturesData, cursor)});
+                newControlView.elements.insert({dataNode.GetName(), ParseElement<ControlView::ElementData>(dataNode, elementNames, texturesData, cursor)});
         }
 
         cursor.SetElementName("");
@@ -238,7 +271,7 @@ void Theme::Load(const std::string &Name) throw (Exception)
             throw cursor.CreateException("images node redifinition");
 
         for(const XML::Node &node : **imagesNodes.begin())
-            images.insert({node.GetName(), ParseElement<ImageData>(node, texturesData, cursor)});
+            images.insert({node.GetName(), ParseElement<ImageData>(node, elementNames, texturesData, cursor)});
     }
 
     XML::ConstNodesSet fontColorsNodes;
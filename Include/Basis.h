@@ -20,14 +20,16 @@ private:
     mutable Vector3 up = {0.0f, 1.0f, 0.0f};
     mutable Vector3 right = {0.0f, 0.0f, 1.0f};
     mutable Matrix4x4 matrix;
+    mutable Matrix4x4 invMatrix;
     mutable bool needMatrixUpdate = true;
+    mutable bool needInvMatrixUpdate = true;
 protected:
     Point3F &Pos() const {return pos;}
     Vector3 &Dir() const {return dir;}
     Vector3 &Up() const {return up;}
     Vector3 &Right() const {return right;}
     Matrix4x4 &Matrix() const {return matrix;}
-    void SetNeedUpdate() {needMatrixUpdate = true;}
+    void SetNeedUpdate() {needMatrixUpdate = needInvMatrixUpdate = true;}
     void DropNeedUpdate() const {needMatrixUpdate = false;}
     bool NeedMatrixUpdate() const {return needMatrixUpdate;}
 public:
@@ -38,6 +40,8 @@ public:
     const Vector3 &GetUp() const;
     const Vector3 &GetRight() const;
     const Matrix4x4 &GetMatrix() const;
+    //kept until the basis changes
+    const Matrix4x4 &GetInvMatrix() const;
 };
 
 class UVNBasis : public IBasis
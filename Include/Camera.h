@@ -18,6 +18,7 @@ class ICamera
 public:
 	virtual ~ICamera(){}
     virtual const Matrix4x4 &GetViewMatrix() const = 0;
+    virtual const Matrix4x4 &GetInvViewMatrix() const = 0;
     virtual const Matrix4x4 &GetProjMatrix() const = 0;
     virtual const Point3F &GetPos() const = 0;
     virtual const Vector3 &GetDir() const = 0;
@@ -39,7 +40,6 @@ class EyeCamera :
 private:
     Vector2 angles;
     bool isFlying = false;
-    mutable Matrix4x4 invertMatrix;
     Matrix4x4 projMatrix;
     float speed = 1.0f;
 public:
@@ -54,7 +54,8 @@ public:
     virtual const Vector3 &GetDir() const {return UVNBasis::GetDir();}
     void SetProjMatrix(const Matrix4x4 &ProjMatrix) { projMatrix = ProjMatrix; }
     virtual const Matrix4x4 &GetProjMatrix() const { return projMatrix; }
-    virtual const Matrix4x4 &GetViewMatrix() const;
+    virtual const Matrix4x4 &GetViewMatrix() const {return UVNBasis::GetInvMatrix();}
+    virtual const Matrix4x4 &GetInvViewMatrix() const {return UVNBasis::GetMatrix();}
 	virtual void Invalidate(float Tf);
 };
 
@@ -9,6 +9,7 @@
 #include <D3DHeaders.h>
 #include <Vector2.h>
 #include <Exception.h>
+#include <Utils/Random.h>
 
 namespace Math
 {
@@ -82,7 +83,7 @@ inline Size<T> Abs(const Size<T> &Size)
 
 inline float Rand(float min, float max)
 {
-    return min + ((float)rand() / (float)RAND_MAX) * (max - min);
+    return Utils::GetThreadRandom().Float(min, max);
 }
 
 inline float Rand(const Range<float> &Range)
@@ -92,7 +93,7 @@ inline float Rand(const Range<float> &Range)
 
 inline INT Rand(INT Min, INT Max)
 {
-    return Min + rand() % (Max - Min);
+    return Min + (INT)Utils::GetThreadRandom().Index((uint32_t)(Max - Min));
 }
 
 inline float RandSNorm()
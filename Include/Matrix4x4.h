@@ -22,9 +22,32 @@ private:
         float m[4][4];
     };
 public:
-    Matrix4x4();
-    Matrix4x4(const Point4F &Part1, const Point4F &Part2, const Point4F &Part3, const Point4F &Part4, bool AsRows = true);
+    MATH_CONSTEXPR Matrix4x4() MATH_NOEXCEPT :
+        a11(1.0f), a12(0.0f), a13(0.0f), a14(0.0f),
+        a21(0.0f), a22(1.0f), a23(0.0f), a24(0.0f),
+        a31(0.0f), a32(0.0f), a33(1.0f), a34(0.0f),
+        a41(0.0f), a42(0.0f), a43(0.0f), a44(1.0f)
+    {}
+    MATH_CONSTEXPR Matrix4x4(float A11, float A12, float A13, float A14,
+                             float A21, float A22, float A23, float A24,
+                             float A31, float A32, float A33, float A34,
+                             float A41, float A42, float A43, float A44) MATH_NOEXCEPT :
+        a11(A11), a12(A12), a13(A13), a14(A14),
+        a21(A21), a22(A22), a23(A23), a24(A24),
+        a31(A31), a32(A32), a33(A33), a34(A34),
+        a41(A41), a42(A42), a43(A43), a44(A44)
+    {}
+    MATH_CONSTEXPR Matrix4x4(const Point4F &Part1, const Point4F &Part2, const Point4F &Part3, const Point4F &Part4, bool AsRows = true) MATH_NOEXCEPT :
+        a11(Part1.x), a12(AsRows ? Part1.y : Part2.x), a13(AsRows ? Part1.z : Part3.x), a14(AsRows ? Part1.w : Part4.x),
+        a21(AsRows ? Part2.x : Part1.y), a22(Part2.y), a23(AsRows ? Part2.z : Part3.y), a24(AsRows ? Part2.w : Part4.y),
+        a31(AsRows ? Part3.x : Part1.z), a32(AsRows ? Part3.y : Part2.z), a33(Part3.z), a34(AsRows ? Part3.w : Part4.z),
+        a41(AsRows ? Part4.x : Part1.w), a42(AsRows ? Part4.y : Part2.w), a43(AsRows ? Part4.z : Part3.w), a44(Part4.w)
+    {}
     float Determinant() const;
+    //last column is (0, 0, 0, 1)
+    bool IsAffine(float Epsilon = 0.0001f) const;
+    //affine with orthonormal rows of rotation
+    bool IsRigid(float Epsilon = 0.0001f) const;
     Vector4 Transform(const Vector4 &V) const;
     Vector3 Transform(const Vector3 &V) const;
     Point3F Transform(const Point3F &V, bool DevideByW = false) const;
@@ -39,15 +62,47 @@ public:
     static Vector3 Transform(const Matrix4x4 &Matrix, const Vector3 &V);
     static Point3F Transform(const Matrix4x4 &Matrix, const Point3F &V, bool DevideByW = false);
     static Vector4 Transform(const Matrix4x4 &Matrix, const Vector4 &V);
+    //batches, output can be the input, strides are distances between elements in bytes
+    static void TransformPoints(const Matrix4x4 &Matrix, const Point3F *Points, Point3F *OutPoints, size_t Count, bool DevideByW = false);
+    static void TransformPoints(const Matrix4x4 &Matrix, const void *Points, size_t Stride, void *OutPoints, size_t OutStride, size_t Count, bool DevideByW = false);
+    static void TransformPoints(const Matrix4x4 &Matrix, const float *X, const float *Y, const float *Z, float *OutX, float *OutY, float *OutZ, size_t Count, bool DevideByW = false);
+    static void TransformVectors(const Matrix4x4 &Matrix, const Vector3 *Vectors, Vector3 *OutVectors, size_t Count);
+    static void TransformVectors(const Matrix4x4 &Matrix, const void *Vectors, size_t Stride, void *OutVectors, size_t OutStride, size_t Count);
+    static void TransformVectors(const Matrix4x4 &Matrix, const float *X, const float *Y, const float *Z, float *OutX, float *OutY, float *OutZ, size_t Count);
+    static void Transform(const Matrix4x4 &Matrix, const Vector4 *Vectors, Vector4 *OutVectors, size_t Count);
     static Matrix4x4 Inverse(const Matrix4x4 &Matrix);
-    static Matrix4x4 Transpose(const Matrix4x4 &Matrix);    
+    //inputs are checked in debug builds only
+    static Matrix4x4 InverseAffine(const Matrix4x4 &Matrix);
+    static Matrix4x4 InverseRigid(const Matrix4x4 &Matrix);
+    static MATH_CONSTEXPR Matrix4x4 Transpose(const Matrix4x4 &M) MATH_NOEXCEPT
+    {
+        return Matrix4x4(M.a11, M.a21, M.a31, M.a41,
+                         M.a12, M.a22, M.a32, M.a42,
+                         M.a13, M.a23, M.a33, M.a43,
+                         M.a14, M.a24, M.a34, M.a44);
+    }
     static Matrix4x4 Mul(const Matrix4x4 &Matrix, float Val);
     static Matrix4x4 Mul(const Matrix4x4 &A, const Matrix4x4 &B);
     static Matrix4x4 Add(const Matrix4x4 &A, const Matrix4x4 &B);
     static Matrix4x4 Sub(const Matrix4x4 &A, const Matrix4x4 &B);
-    static Matrix4x4 Translation(const Point3F &Pos);
-    static Matrix4x4 Scalling(const Size3F &Size);
-    static Matrix4x4 Scalling(float Factor);
+    static MATH_CONSTEXPR Matrix4x4 Translation(const Point3F &Pos) MATH_NOEXCEPT
+    {
+        return Matrix4x4(1.0f, 0.0f, 0.0f, 0.0f,
+                         0.0f, 1.0f, 0.0f, 0.0f,
+                         0.0f, 0.0f, 1.0f, 0.0f,
+                         Pos.x, Pos.y, Pos.z, 1.0f);
+    }
+    static MATH_CONSTEXPR Matrix4x4 Scalling(const Size3F &Size) MATH_NOEXCEPT
+    {
+        return Matrix4x4(Size.width, 0.0f, 0.0f, 0.0f,
+                         0.0f, Size.height, 0.0f, 0.0f,
+                         0.0f, 0.0f, Size.depth, 0.0f,
+                         0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    static MATH_CONSTEXPR Matrix4x4 Scalling(float Factor) MATH_NOEXCEPT
+    {
+        return Scalling(Size3F(Factor, Factor, Factor));
+    }
     static Matrix4x4 RotationX(float Angle);
     static Matrix4x4 RotationY(float Angle);
     static Matrix4x4 RotationZ(float Angle);
@@ -0,0 +1,64 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <Vector2.h>
+#include <Matrix4x4.h>
+#include <stddef.h>
+
+//rotations are composed in the order of matrices: A * B is A, then B.
+//Angles are in the layout of Matrix4x4::RotationYawPitchRoll: x is pitch, y is yaw, z is roll
+class Quaternion
+{
+public:
+    float x, y, z, w;
+    MATH_CONSTEXPR Quaternion() MATH_NOEXCEPT : x(0.0f), y(0.0f), z(0.0f), w(1.0f){}
+    MATH_CONSTEXPR Quaternion(float X, float Y, float Z, float W) MATH_NOEXCEPT : x(X), y(Y), z(Z), w(W){}
+    float Lenght() const {return sqrtf(Dot(*this, *this));}
+    void Normalize(){*this = Normalize(*this);}
+    Vector3 Rotate(const Vector3 &V) const {return Rotate(*this, V);}
+    Point3F Rotate(const Point3F &P) const {return Rotate(*this, Cast<Vector3>(P));}
+    Matrix4x4 ToMatrix() const {return ToMatrix(*this);}
+    MATH_CONSTEXPR Quaternion operator *(const Quaternion &Q) const MATH_NOEXCEPT {return Mul(*this, Q);}
+    Quaternion &operator *=(const Quaternion &Q) MATH_NOEXCEPT {return *this = Mul(*this, Q);}
+    MATH_CONSTEXPR bool operator ==(const Quaternion &Q) const MATH_NOEXCEPT {return x == Q.x && y == Q.y && z == Q.z && w == Q.w;}
+    MATH_CONSTEXPR bool operator !=(const Quaternion &Q) const MATH_NOEXCEPT {return !operator ==(Q);}
+    static MATH_CONSTEXPR float Dot(const Quaternion &A, const Quaternion &B) MATH_NOEXCEPT
+    {
+        return A.x * B.x + A.y * B.y + A.z * B.z + A.w * B.w;
+    }
+    static MATH_CONSTEXPR Quaternion Mul(const Quaternion &A, const Quaternion &B) MATH_NOEXCEPT
+    {
+        return Quaternion(B.w * A.x + B.x * A.w + B.y * A.z - B.z * A.y,
+                          B.w * A.y - B.x * A.z + B.y * A.w + B.z * A.x,
+                          B.w * A.z + B.x * A.y - B.y * A.x + B.z * A.w,
+                          B.w * A.w - B.x * A.x - B.y * A.y - B.z * A.z);
+    }
+    //inverse of unit quaternions
+    static MATH_CONSTEXPR Quaternion Conjugate(const Quaternion &Q) MATH_NOEXCEPT
+    {
+        return Quaternion(-Q.x, -Q.y, -Q.z, Q.w);
+    }
+    static Quaternion Inverse(const Quaternion &Q);
+    static Quaternion Normalize(const Quaternion &Q);
+    static Quaternion RotationAxis(const Vector3 &Axis, float Angle);
+    static Quaternion RotationYawPitchRoll(float Yaw, float Pitch, float Roll);
+    static Quaternion RotationYawPitchRoll(const Vector3 &Rotation);
+    static Vector3 ToYawPitchRoll(const Quaternion &Q);
+    //rotation part of the matrix, it has to be without scalling
+    static Quaternion FromMatrix(const Matrix4x4 &Matrix);
+    static Matrix4x4 ToMatrix(const Quaternion &Q);
+    //scalling, then rotation, then translation, as Scalling * ToMatrix * Translation
+    static Matrix4x4 ToMatrix(const Quaternion &Q, const Size3F &Scalling, const Point3F &Pos);
+    //shortest arc, Factor in [0, 1]; Nlerp is cheaper and good enough for close rotations
+    static Quaternion Slerp(const Quaternion &A, const Quaternion &B, float Factor);
+    static Quaternion Nlerp(const Quaternion &A, const Quaternion &B, float Factor);
+    static Vector3 Rotate(const Quaternion &Q, const Vector3 &V);
+    //batches go through the rotation matrix, output can be the input
+    static void RotateVectors(const Quaternion &Q, const Vector3 *Vectors, Vector3 *OutVectors, size_t Count);
+    static void RotateVectors(const Quaternion &Q, const float *X, const float *Y, const float *Z, float *OutX, float *OutY, float *OutZ, size_t Count);
+};
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <MeshesFwd.h>
 #include <Vector2.h>
 #include <Matrix4x4.h>
+#include <Quaternion.h>
 #include <Shader.h>
 #include <SceneManagementFwd.h>
 #include <Utils/SharedCOM.h>
@@ -133,4 +134,15 @@ public:
     Object3D();
 };
 
+//rotations are composed without angles, the world matrix is built without trigonometry
+class QuaternionObject3D : public GenericObject<Point3F, Size3F, Quaternion>
+{
+protected:
+    virtual void CalculateMatrix();
+public:
+    virtual ~QuaternionObject3D(){}
+    QuaternionObject3D();
+    void Rotate(const Quaternion &Delta) {SetRotation(Quaternion::Normalize(GetRotation() * Delta));}
+};
+
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ DECLARE_EXCEPTION(DrawingContainerException);
 class IObject;
 class Object2D;
 class Object3D;
+class QuaternionObject3D;
 class Rectangle2D;
 
 typedef std::vector<IObject*> ObjectsGroup;
@@ -8,150 +8,291 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <map>
-#include <sstream>
-#include <algorithm>
 #include <sstream>
+#include <ctype.h>
+#include <type_traits>
 #include <memory.h>
 #include <Exception.h>
 #include <Vector2.h>
 #include <Utils/ToString.h>
+#include <Utils/FromChars.h>
+#include <Utils/BinaryArchive.h>
+#include <Utils/Random.h>
 
 DECLARE_EXCEPTION(FormatException);
 DECLARE_EXCEPTION(ArraySizeException);
 DECLARE_EXCEPTION(NumberConvertionError);
 
+//numbers are read without streams and locale, chars are read as numbers too
 template<class TVar>
 TVar ParseNumber(const std::wstring &String)
 {
-    std::wistringstream iss(String);
+    std::string narrowString(String.size(), '\0');
+    for(size_t c = 0; c < String.size(); c++){
+        if((uint32_t)String[c] > 127)
+            throw NumberConvertionError(String + L" is not a number");
 
-    TVar val;
-    iss >> std::noskipws >> val;
+        narrowString[c] = (char)String[c];
+    }
 
-    if(!iss.eof() || iss.fail())
+    TVar val;
+    if(!Utils::FromString(narrowString, val))
         throw NumberConvertionError(String + L" is not a number");
 
     return val;
 }
 
 template<class TVar>
-TVar ParseNumber(const std::string &String)
+TVar ParseNumber(const char *Begin, const char *End)
 {
-    std::istringstream iss(String);
-
     TVar val;
-    iss >> std::noskipws >> val;
-
-    if(!iss.eof() || iss.fail())
-        throw NumberConvertionError(String + " is not a number");
+    if(Begin == End || Utils::FromChars(Begin, End, val) != End)
+        throw NumberConvertionError(std::string(Begin, End) + " is not a number");
 
     return val;
 }
 
-template<class TVar, class RandFunc>
-TVar GetRandomFromRange(const std::string &FullString, RandFunc RandFunction) throw (FormatException)
+template<class TVar>
+TVar ParseNumber(const std::string &String)
 {
-    auto vals = SerializerTools<StringParser>::PairFromString(FullString, '<', '>');
-
-    TVar minVal = ParseNumber<TVar>(vals.first.c_str()), maxVal = ParseNumber<TVar>(vals.second.c_str());
-
-    if(minVal > maxVal) 
-        throw FormatException("invalid values for string " + FullString);
-
-    return RandFunction(minVal, maxVal);
+    return ParseNumber<TVar>(String.data(), String.data() + String.size());
 }
 
-template <class Parser, class ParseFunc>
-typename Parser::ValueType ParseValue(const std::string &FullString, ParseFunc ParseFunction) throw (FormatException)
+//values are trees of (), {}, <> and [] statements, items of a statement are separated by commas.
+//Tree is built in one pass over the string and keeps pointers into it, so the string must outlive the tree
+class ValueTree final
 {
-    std::string values = FullString;
-    values.erase(remove_if(values.begin(), values.end(), isspace), values.end());
+public:
+    static const uint32_t INVALID_NODE = 0xFFFFFFFF;
+    struct Node
+    {
+        //opening char of a statement, 0 for plain text
+        char bracket;
+        //text of the node without surrounding spaces, brackets are included
+        const char *begin;
+        const char *end;
+        uint32_t firstChild;
+        uint32_t next;
+        uint32_t childrenCount;
+    };
+    static bool IsSpace(char Char) {return Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r' || Char == '\v' || Char == '\f';}
+private:
+    enum ItemState
+    {
+        ITEM_STATE_EMPTY,
+        ITEM_STATE_STATEMENT,
+        ITEM_STATE_CLOSED_STATEMENT,
+        ITEM_STATE_TEXT
+    };
+    struct Statement
+    {
+        char bracket;
+        uint32_t node;
+        uint32_t lastChild;
+        const char *itemBegin;
+        uint32_t itemFirstNode;
+        ItemState itemState;
+    };
+    std::vector<Node> nodes;
+    std::vector<Statement> statements;
+    const char *sourceBegin;
+    const char *sourceEnd;
+    static char GetOpeningBracket(char Char)
+    {
+        switch(Char){
+        case ')':
+            return '(';
+        case '}':
+            return '{';
+        case '>':
+            return '<';
+        case ']':
+            return '[';
+        default:
+            return 0;
+        }
+    }
+    uint32_t AddNode(char Bracket, const char *Begin, const char *End)
+    {
+        Node node = {Bracket, Begin, End, INVALID_NODE, INVALID_NODE, 0};
+        nodes.push_back(node);
+        return (uint32_t)nodes.size() - 1;
+    }
+    void FinishItem(Statement &Parent, const char *End, bool Last)
+    {
+        const char *begin = Parent.itemBegin;
+        while(begin != End && IsSpace(*begin))
+            begin++;
+        while(End != begin && IsSpace(*(End - 1)))
+            End--;
+
+        //empty statement has no items, trailing comma adds nothing
+        if(Last && begin == End && Parent.node != INVALID_NODE)
+            return;
+
+        uint32_t item = Parent.itemFirstNode;
+        if(Parent.itemState != ITEM_STATE_CLOSED_STATEMENT){
+            //statements inside of text are only checked for balance
+            nodes.resize(Parent.itemFirstNode);
+            item = AddNode(0, begin, End);
+        }
 
-    RangeI params = GetStatementParameters(values, '{', '}');
-    if(params.minVal == -1 && params.maxVal == -1)
-        return ParseFunction(values);
+        if(Parent.node == INVALID_NODE)
+            return;
 
-    std::vector<typename Parser::ValueType> arr = SerializerTools<Parser>::ArrayFromString(values, '{', '}', ',');
-    return arr[rand() % arr.size()];
-}
+        if(Parent.lastChild != INVALID_NODE)
+            nodes[Parent.lastChild].next = item;
+        else
+            nodes[Parent.node].firstChild = item;
 
-template<class Func>
-void ParseString(const std::string &String, Func Operator) throw (Exception)
-{
-    std::map<char, char> specCharsMapping;
+        Parent.lastChild = item;
+        nodes[Parent.node].childrenCount++;
+    }
+public:
+    ValueTree(const ValueTree &) = delete;
+    ValueTree &operator= (const ValueTree &) = delete;
+    ValueTree() : sourceBegin(NULL), sourceEnd(NULL){}
+    explicit ValueTree(const std::string &String) throw (FormatException) {Parse(String.data(), String.data() + String.size());}
+    void Parse(const char *Begin, const char *End) throw (FormatException)
+    {
+        sourceBegin = Begin;
+        sourceEnd = End;
+        nodes.clear();
+        statements.clear();
+
+        Statement root = {0, INVALID_NODE, INVALID_NODE, Begin, 0, ITEM_STATE_EMPTY};
+        statements.push_back(root);
+
+        for(const char *pos = Begin; pos != End; pos++){
+            char ch = *pos;
+            Statement &current = statements.back();
+
+            if(IsSpace(ch))
+                continue;
+
+            if(ch == '(' || ch == '{' || ch == '<' || ch == '['){
+                current.itemState = current.itemState == ITEM_STATE_EMPTY ? ITEM_STATE_STATEMENT : ITEM_STATE_TEXT;
+
+                Statement statement = {ch, AddNode(ch, pos, pos + 1), INVALID_NODE, pos + 1, (uint32_t)nodes.size(), ITEM_STATE_EMPTY};
+                statements.push_back(statement);
+            }else if(GetOpeningBracket(ch)){
+                if(statements.size() == 1 || current.bracket != GetOpeningBracket(ch))
+                    throw FormatException(Utils::ToString("unexpected character in '", ch, "' in string ", GetSource(), ". Cymbol ", (pos - Begin + 1)));
+
+                FinishItem(current, pos, true);
+                nodes[current.node].end = pos + 1;
+                statements.pop_back();
+
+                Statement &parent = statements.back();
+                if(parent.itemState == ITEM_STATE_STATEMENT)
+                    parent.itemState = ITEM_STATE_CLOSED_STATEMENT;
+            }else if(ch == ',' && statements.size() > 1){
+                FinishItem(current, pos, false);
+                current.itemBegin = pos + 1;
+                current.itemFirstNode = (uint32_t)nodes.size();
+                current.itemState = ITEM_STATE_EMPTY;
+            }else
+                current.itemState = ITEM_STATE_TEXT;
+        }
+
+        if(statements.size() != 1)
+            throw FormatException("invalid string " + GetSource());
 
-    std::vector<char> specCharsLog;
+        FinishItem(statements.back(), End, true);
+    }
+    uint32_t GetRoot() const {return 0;}
+    const Node &GetNode(uint32_t Index) const {return nodes[Index];}
+    std::string GetText(uint32_t Index) const {return std::string(nodes[Index].begin, nodes[Index].end);}
+    bool IsEmpty(uint32_t Index) const {return nodes[Index].begin == nodes[Index].end;}
+    std::string GetSource() const {return std::string(sourceBegin, sourceEnd);}
+};
 
-    specCharsMapping[']'] = '[';
-    specCharsMapping[')'] = '(';
-    specCharsMapping['}'] = '{';
-    specCharsMapping['>'] = '<';
+template<class TVar, class RandFunc>
+TVar GetRandomFromRange(const ValueTree &Tree, uint32_t RangeNode, RandFunc RandFunction) throw (FormatException)
+{
+    const ValueTree::Node &range = Tree.GetNode(RangeNode);
+    if(range.childrenCount != 2)
+        throw FormatException("invalid string " + Tree.GetText(RangeNode));
 
-    int strInd = 0;
+    const ValueTree::Node &minNode = Tree.GetNode(range.firstChild), &maxNode = Tree.GetNode(minNode.next);
+    TVar minVal = ParseNumber<TVar>(minNode.begin, minNode.end), maxVal = ParseNumber<TVar>(maxNode.begin, maxNode.end);
 
-    for(char c : String){
+    if(minVal > maxVal) 
+        throw FormatException("invalid values for string " + Tree.GetText(RangeNode));
 
-        if(c == '[' || c == '(' || c == '{' || c == '<')
-            specCharsLog.push_back(c);
+    return RandFunction(minVal, maxVal);
+}
 
-        if(c == ']' || c == ')' || c == '}' || c == '>'){
+//{a,b,c} is a random choice, every variant is checked, one is returned
+template <class Parser, class ParseFunc>
+typename Parser::ValueType ParseValue(const ValueTree &Tree, uint32_t ValueNode, ParseFunc ParseFunction) throw (FormatException)
+{
+    const ValueTree::Node &node = Tree.GetNode(ValueNode);
+    if(node.bracket != '{')
+        return ParseFunction(Tree, ValueNode);
 
-            if(specCharsLog.size() == 0 || specCharsMapping[c] != specCharsLog.back())
-                throw FormatException(Utils::ToString("unexpected character in '", c, "' in string ", String, ". Cymbol ", (strInd + 1)));
+    if(!node.childrenCount)
+        throw FormatException("invalid string " + Tree.GetText(ValueNode));
 
-            specCharsLog.pop_back();
-        }
+    uint32_t chosen = Utils::GetThreadRandom().Index(node.childrenCount), index = 0;
 
-        Operator(c, specCharsLog, strInd++);
+    typename Parser::ValueType value = typename Parser::ValueType();
+    for(uint32_t c = node.firstChild; c != ValueTree::INVALID_NODE; c = Tree.GetNode(c).next, index++){
+        typename Parser::ValueType variant = Parser::FromTree(Tree, c);
+        if(index == chosen)
+            value = variant;
     }
 
-    if(specCharsLog.size())
-        throw FormatException("invalid string " + String);
+    return value;
+}
+
+//lengths of strings and arrays are 32 bit little endian numbers before the data
+template<typename T>
+class BinarySerializerSize
+{
+public:
+    static size_t Get(const T &Var){ return sizeof(T);}
 };
 
-inline RangeI GetStatementParameters(const std::string &String, char OpenSymbol, char CloseSymbol)
+template<>
+class BinarySerializerSize<std::string>
 {
-    RangeI params = {-1, -1};
+public:
+    static size_t Get(const std::string &Var){ return sizeof(Utils::BinaryLength) + Var.length();}
+};
 
-    ParseString(String, [&](char Char, const std::vector<char> &SpecCharsLog, int StrInd)
+template<typename T>
+class BinarySerializerSize<std::vector<T> >
+{
+public:
+    static size_t Get(const std::vector<T> &Var)
     {
-        if(Char == OpenSymbol && SpecCharsLog.size() == 1)
-            params.minVal = StrInd;
-        else if(Char == CloseSymbol && SpecCharsLog.size() == 0)
-            params.maxVal = StrInd;
-    });
-
-    return params;
-}
+        size_t size = sizeof(Utils::BinaryLength);
+        for(size_t i = 0; i < Var.size(); i++)
+            size += BinarySerializerSize<T>::Get(Var[i]);
+        return size;
+    }
+};
 
 template<typename Parser>
 class SerializerTools
 {
 public:
 	typedef std::pair<typename Parser::ValueType, typename Parser::ValueType> Pair;	
-	static Pair PairFromString(const std::string &String, char OpenSymbol, char CloseSymbol) throw (FormatException)
+	static Pair PairFromTree(const ValueTree &Tree, uint32_t PairNode, char OpenSymbol) throw (FormatException)
 	{
-		RangeI params = GetStatementParameters(String, OpenSymbol, CloseSymbol);
-		
-		if(params.minVal == -1 || params.maxVal == -1) throw FormatException("invalid string " + String);
-			
-		bool isSecondVal = false;
-		std::string firstVal = "", secondVal = "";
-
-		std::string values = String.substr(params.minVal + 1, params.maxVal - params.minVal - 1);		
-
-        ParseString(values, [&](char Char, const std::vector<char> &SpecCharsLog, int)
-        {
-            if(Char == ',' && SpecCharsLog.size() == 0)
-                isSecondVal = true;
-            else
-                (isSecondVal ? secondVal : firstVal) += Char;
-        });
-
-		if(firstVal == "" || secondVal == "") throw FormatException("invalid string " + String);
-		
-		return std::make_pair(Parser::FromString(firstVal), Parser::FromString(secondVal));
+		const ValueTree::Node &node = Tree.GetNode(PairNode);
+		if(node.bracket != OpenSymbol || node.childrenCount != 2) throw FormatException("invalid string " + Tree.GetText(PairNode));
+
+		uint32_t first = node.firstChild, second = Tree.GetNode(first).next;
+		if(Tree.IsEmpty(first) || Tree.IsEmpty(second)) throw FormatException("invalid string " + Tree.GetText(PairNode));
+
+		return std::make_pair(Parser::FromTree(Tree, first), Parser::FromTree(Tree, second));
+	}
+	static Pair PairFromString(const std::string &String, char OpenSymbol) throw (FormatException)
+	{
+		ValueTree tree(String);
+		return PairFromTree(tree, tree.GetRoot(), OpenSymbol);
 	}
 	static std::string PairToString(const Pair &DataPair, char OpenSymbol, char CloseSymbol) throw (FormatException)
 	{
@@ -163,38 +304,65 @@ public:
 	{
 		Pair outPair;
 		outPair.first = Parser::FromBinary(Data);
-		outPair.second = Parser::FromBinary(Data + sizeof(Parser::ValueType));	
+		outPair.second = Parser::FromBinary(Data + BinarySerializerSize<typename Parser::ValueType>::Get(outPair.first));
 		return outPair;
 	}
 	static void PairToBinary(const Pair &DataPair, char* Data)
 	{		
 		Parser::ToBinary(DataPair.first, Data);
-		Parser::ToBinary(DataPair.second, Data + sizeof(Parser::ValueType));
+		Parser::ToBinary(DataPair.second, Data + BinarySerializerSize<typename Parser::ValueType>::Get(DataPair.first));
  	}
 	typedef std::vector<typename Parser::ValueType> Array;
-	static Array ArrayFromString(const std::string &String, char OpenSymbol, char CloseSymbol, char Delimiter) throw (FormatException)
+private:
+    //numbers are stored as they are in memory on little endian hosts, so they are copied at once
+    typedef typename Parser::ValueType ElementType;
+#ifdef BINARY_ARCHIVE_BIG_ENDIAN
+    typedef std::false_type IsRawArray;
+#else
+    typedef std::integral_constant<bool, std::is_arithmetic<ElementType>::value && !std::is_same<ElementType, bool>::value> IsRawArray;
+#endif
+    static void ElementsFromBinary(const char *Data, Array &OutArray, std::true_type)
+    {
+        if(!OutArray.empty())
+            memcpy(OutArray.data(), Data, sizeof(ElementType) * OutArray.size());
+    }
+    static void ElementsFromBinary(const char *Data, Array &OutArray, std::false_type)
+    {
+        for(size_t i = 0; i < OutArray.size(); i++){
+            OutArray[i] = Parser::FromBinary(Data);
+            Data += BinarySerializerSize<ElementType>::Get(OutArray[i]);
+        }
+    }
+    static void ElementsToBinary(const Array &DataArr, char *Data, std::true_type)
+    {
+        if(!DataArr.empty())
+            memcpy(Data, DataArr.data(), sizeof(ElementType) * DataArr.size());
+    }
+    static void ElementsToBinary(const Array &DataArr, char *Data, std::false_type)
+    {
+        for(size_t i = 0; i < DataArr.size(); i++){
+            Parser::ToBinary(DataArr[i], Data);
+            Data += BinarySerializerSize<ElementType>::Get(DataArr[i]);
+        }
+    }
+public:
+	static Array ArrayFromTree(const ValueTree &Tree, uint32_t ArrayNode, char OpenSymbol) throw (FormatException)
 	{
-		RangeI params = GetStatementParameters(String, OpenSymbol, CloseSymbol);
-		
-		if(params.minVal == -1 || params.maxVal == -1) throw FormatException("invalid string " + String);
-			
-		std::string tmpVar = "";
-		Array outData;
-		std::string values = String.substr(params.minVal + 1, params.maxVal - params.minVal - 1);	
+		const ValueTree::Node &node = Tree.GetNode(ArrayNode);
+		if(node.bracket != OpenSymbol) throw FormatException("invalid string " + Tree.GetText(ArrayNode));
 
-        ParseString(values, [&](char Char, const std::vector<char> &SpecCharsLog, int)
-        {
-            if(Char == Delimiter && SpecCharsLog.size() == 0 && tmpVar != ""){
-                outData.push_back(Parser::FromString(tmpVar));
-                tmpVar = "";
-            }else
-                tmpVar += Char;
-        });
-
-		if(tmpVar != "")outData.push_back(Parser::FromString(tmpVar));
+		Array outData;
+		outData.reserve(node.childrenCount);
+		for(uint32_t c = node.firstChild; c != ValueTree::INVALID_NODE; c = Tree.GetNode(c).next)
+			outData.push_back(Parser::FromTree(Tree, c));
 
 		return outData;
 	}
+	static Array ArrayFromString(const std::string &String, char OpenSymbol) throw (FormatException)
+	{
+		ValueTree tree(String);
+		return ArrayFromTree(tree, tree.GetRoot(), OpenSymbol);
+	}
 	static std::string ArrayToString(const Array &Data, char OpenSymbol, char CloseSymbol, char Delimiter) throw (FormatException)
 	{
 		std::ostringstream sstrm;		
@@ -208,54 +376,64 @@ public:
 	}	
 	static Array ArrayFromBinary(const char* Data)
 	{
-		Array outArray;
-		const size_t arrSize = *reinterpret_cast<const size_t*>(Data);
-		Data += sizeof(size_t);
-		for(size_t i = 0; i < arrSize; i++){
-			outArray.push_back(Parser::FromBinary(Data));
-			Data += sizeof(typename Parser::ValueType);
-		}
+		Utils::BinaryLength arrSize;
+		memcpy(&arrSize, Data, sizeof(arrSize));
+		Data += sizeof(arrSize);
+
+		Array outArray(Utils::FromLittleEndian(arrSize));
+		ElementsFromBinary(Data, outArray, IsRawArray());
 		return outArray;
 	}
 	static void ArrayToBinary(const Array &DataArr, char* Data)
 	{	
-		*reinterpret_cast<size_t*>(Data) = DataArr.size();
-		Data += sizeof(size_t);
-		for(size_t i = 0, size = DataArr.size(); i < size; i++){
-			Parser::ToBinary(DataArr[i], Data);
-			Data += sizeof(typename Parser::ValueType);
-		}
+		Utils::BinaryLength arrSize = Utils::ToLittleEndian((Utils::BinaryLength)DataArr.size());
+		memcpy(Data, &arrSize, sizeof(arrSize));
+		ElementsToBinary(DataArr, Data + sizeof(arrSize), IsRawArray());
  	}
 };
 
 template<typename T>
 class NumberConverter
 {
+private:
+	static bool IsHex(const char *Begin, const char *End)
+	{
+		if(Begin != End && (*Begin == '-' || *Begin == '+'))
+			Begin++;
+
+		return End - Begin > 2 && Begin[0] == '0' && (Begin[1] == 'x' || Begin[1] == 'X');
+	}
 public:
-	static T FromString(const std::string &String) throw (Exception)
+	static bool TryFromChars(const char *Begin, const char *End, T &Value)
+	{
+		return Begin != End && Utils::FromChars(Begin, End, Value) == End;
+	}
+	static T FromTree(const ValueTree &Tree, uint32_t ValueNode) throw (Exception)
 	{ 			
-		RangeI params = GetStatementParameters(String, '<', '>');
-
-		if(params.minVal == -1 && params.maxVal == -1){
-			std::string lowerCase = String;
-			std::transform(lowerCase.begin(), lowerCase.end(), lowerCase.begin(), ::tolower);
-			if(lowerCase.find("0x") != std::string::npos){
-				long int outVar;			    
-				std::stringstream ss;
-				ss << std::hex << lowerCase;
-				ss >> outVar;
-				return static_cast<T>(outVar);
-			}
-
-			return ParseNumber<T>(String);
+		const ValueTree::Node &node = Tree.GetNode(ValueNode);
+
+		if(node.bracket == '<'){
+			return static_cast<T>(GetRandomFromRange<int>(Tree, ValueNode, 
+				[](int MinVal, int MaxVal)
+				{
+					return Utils::GetThreadRandom().Int(MinVal, MaxVal);
+				}
+			));
 		}
 
-        return GetRandomFromRange<int>(String, 
-            [](int MinVal, int MaxVal)
-            {
-                return MinVal + (rand() % ((MaxVal - MinVal) + 1));
-            }
-        );
+		T outVar;
+		if(!IsHex(node.begin, node.end))
+			return ParseNumber<T>(node.begin, node.end);
+
+		//bits of the unsigned value are kept, so 0xFFFFFFFF is -1 for int
+		typename std::make_unsigned<T>::type bits;
+		if(Utils::FromCharsHex(node.begin, node.end, bits) == node.end)
+			return static_cast<T>(bits);
+
+		if(Utils::FromCharsHex(node.begin, node.end, outVar) != node.end)
+			throw NumberConvertionError(Tree.GetText(ValueNode) + " is not a number");
+
+		return outVar;
 	}
 };
 
@@ -263,17 +441,21 @@ template<>
 class NumberConverter<float>
 {
 public:
-	static float FromString(const std::string &String)
+	static bool TryFromChars(const char *Begin, const char *End, float &Value)
 	{
-		RangeI params = GetStatementParameters(String, '<', '>');
+		return Begin != End && Utils::FromChars(Begin, End, Value) == End;
+	}
+	static float FromTree(const ValueTree &Tree, uint32_t ValueNode) throw (Exception)
+	{
+		const ValueTree::Node &node = Tree.GetNode(ValueNode);
 
-		if(params.minVal == -1 && params.maxVal == -1)
-			return ParseNumber<float>(String);
+		if(node.bracket != '<')
+			return ParseNumber<float>(node.begin, node.end);
 		
-        return GetRandomFromRange<float>(String,
+        return GetRandomFromRange<float>(Tree, ValueNode,
             [](float MinVal, float MaxVal)
             {
-                return MinVal + ((MaxVal - MinVal) * (static_cast<float>(rand() % 100) * 0.01f));
+                return Utils::GetThreadRandom().Float(MinVal, MaxVal);
             }
         );
 	}
@@ -283,46 +465,50 @@ template<>
 class NumberConverter<bool>
 {
 private:
-	static bool ParseVal(const std::string &String)
+	static bool IsWord(const char *Begin, const char *End, const char *Word)
+	{
+		for(; Begin != End && *Word; Begin++, Word++)
+			if(tolower((unsigned char)*Begin) != *Word)
+				return false;
+
+		return Begin == End && !*Word;
+	}
+	static bool ParseVal(const ValueTree &Tree, uint32_t ValueNode)
 	{
-		std::string str = String;
-		std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+		const ValueTree::Node &node = Tree.GetNode(ValueNode);
 
-		bool outVal = false;
-		if(str == "true" || str == "yes" || str == "1")
-			outVal = true;
-		else if(str == "false" || str == "no" || str == "0")
-			outVal = false;
-		else throw FormatException("Invalid value " + String);
+		bool outVal;
+		if(!TryFromChars(node.begin, node.end, outVal))
+			throw FormatException("Invalid value " + Tree.GetText(ValueNode));
 
 		return outVal;
 	}
 public:
-	static bool FromString(const std::string &String)
+	static bool TryFromChars(const char *Begin, const char *End, bool &Value)
 	{
-		RangeI params = GetStatementParameters(String, '<', '>');
+		if(IsWord(Begin, End, "true") || IsWord(Begin, End, "yes") || IsWord(Begin, End, "1"))
+			Value = true;
+		else if(IsWord(Begin, End, "false") || IsWord(Begin, End, "no") || IsWord(Begin, End, "0"))
+			Value = false;
+		else
+			return false;
 
-		if(params.minVal == -1 && params.maxVal == -1){			
-			return ParseVal(String);			
-		}else if(params.minVal == -1 || params.maxVal == -1)
-			throw FormatException("invalid random value syntax for sring " + String);
+		return true;
+	}
+	static bool FromTree(const ValueTree &Tree, uint32_t ValueNode)
+	{
+		const ValueTree::Node &node = Tree.GetNode(ValueNode);
 
-		std::string minValStr, maxValStr;
-		
-		bool isSecondVal = false;
-		std::string values = String.substr(params.minVal + 1, params.maxVal - params.minVal - 1);
-		
-		values.erase(remove_if(values.begin(), values.end(), isspace), values.end());
+		if(node.bracket != '<')
+			return ParseVal(Tree, ValueNode);
 
-		for(size_t i = 0; i < values.size(); i++){
-			if(values[i] == ',') {isSecondVal = true; continue;}
-			(isSecondVal ? maxValStr : minValStr) += values[i];	
-		}	
-		
-		ParseVal(minValStr);
-		ParseVal(maxValStr);
+		if(node.childrenCount != 2)
+			throw FormatException("invalid random value syntax for sring " + Tree.GetText(ValueNode));
+
+		ParseVal(Tree, node.firstChild);
+		ParseVal(Tree, Tree.GetNode(node.firstChild).next);
 
-		return rand() % 2 == 1;
+		return Utils::GetThreadRandom().Bool();
 	}
 };
 
@@ -331,9 +517,23 @@ class NumericParser
 {
 public:
 	typedef T ValueType;
+	static bool TryFromChars(const char *Begin, const char *End, T &Value)
+	{
+		return Converter::TryFromChars(Begin, End, Value);
+	}
 	static T FromString(const std::string &String) throw (FormatException)
 	{
-        return ParseValue<NumericParser<T, Converter>>(String, Converter::FromString);
+        //plain numbers dont need the tree
+        T value;
+        if(Converter::TryFromChars(String.data(), String.data() + String.size(), value))
+            return value;
+
+        ValueTree tree(String);
+        return FromTree(tree, tree.GetRoot());
+	}
+	static T FromTree(const ValueTree &Tree, uint32_t ValueNode) throw (FormatException)
+	{
+        return ParseValue<NumericParser<T, Converter>>(Tree, ValueNode, Converter::FromTree);
 	}
 	static std::string ToString(const T &Value)
 	{
@@ -343,11 +543,14 @@ public:
 	}
 	static T FromBinary(const char* Data)
 	{
-		return *((T*)Data);
+		T value;
+		memcpy(&value, Data, sizeof(T));
+		return Utils::FromLittleEndian(value);
 	}
 	static void ToBinary(const T &Value, char *OutData)
 	{				
-		memcpy(OutData, (char*)&Value, sizeof(T));
+		T value = Utils::ToLittleEndian(Value);
+		memcpy(OutData, &value, sizeof(T));
 	}
 };
 
@@ -358,11 +561,16 @@ public:
 	typedef VectorType ValueType;
 	static VectorType FromString(const std::string &String) throw (FormatException)
 	{
+        ValueTree tree(String);
+        return FromTree(tree, tree.GetRoot());
+	}
+	static VectorType FromTree(const ValueTree &Tree, uint32_t ValueNode) throw (FormatException)
+	{
         typedef BasePoint2Parser<Parser, VectorType> ThisType;
-        return ParseValue<ThisType>(String, 
-            [](const std::string &Str)
+        return ParseValue<ThisType>(Tree, ValueNode, 
+            [](const ValueTree &PairTree, uint32_t PairNode)
             {
-                SerializerTools<Parser>::Pair pair = SerializerTools<Parser>::PairFromString(Str,'(', ')');
+                typename SerializerTools<Parser>::Pair pair = SerializerTools<Parser>::PairFromTree(PairTree, PairNode, '(');
                 return VectorType(pair.first, pair.second);
             }
         );
@@ -390,17 +598,22 @@ class BasePoint3Parser
 public:
     typedef PointType ValueType;
     static PointType FromString(const std::string &String)
+    {
+        ValueTree tree(String);
+        return FromTree(tree, tree.GetRoot());
+    }
+    static PointType FromTree(const ValueTree &Tree, uint32_t ValueNode)
     {
         typedef BasePoint3Parser<Parser, PointType> ThisType;
-        return ParseValue<ThisType>(String, 
-            [](const std::string &Str) -> PointType
+        return ParseValue<ThisType>(Tree, ValueNode, 
+            [](const ValueTree &PointTree, uint32_t PointNode) -> PointType
             {
-                SerializerTools<Parser>::Array arr = SerializerTools<Parser>::ArrayFromString(Str, '(', ')', ',');
-                
-                if(arr.size() != 3)
-                    throw FormatException("cant cast " + Str + " to BasePoint3");
+                const ValueTree::Node &node = PointTree.GetNode(PointNode);
+                if(node.bracket != '(' || node.childrenCount != 3)
+                    throw FormatException("cant cast " + PointTree.GetText(PointNode) + " to BasePoint3");
 
-                return {arr[0], arr[1], arr[2]};
+                uint32_t x = node.firstChild, y = PointTree.GetNode(x).next, z = PointTree.GetNode(y).next;
+                return {Parser::FromTree(PointTree, x), Parser::FromTree(PointTree, y), Parser::FromTree(PointTree, z)};
             }
         );
     }
@@ -411,17 +624,17 @@ public:
     static PointType FromBinary(const char *RawData)
     {
         PointType data;
-        data.x = Parser::FromBinary(RawData); RawData += sizeof(Parser::ValueType);
-        data.y = Parser::FromBinary(RawData); RawData += sizeof(Parser::ValueType);
-        data.z = Parser::FromBinary(RawData); RawData += sizeof(Parser::ValueType);
+        data.x = Parser::FromBinary(RawData); RawData += sizeof(typename Parser::ValueType);
+        data.y = Parser::FromBinary(RawData); RawData += sizeof(typename Parser::ValueType);
+        data.z = Parser::FromBinary(RawData); RawData += sizeof(typename Parser::ValueType);
 
         return data;
     }
     static void ToBinary(const PointType &Data, char *RawData)
     {
-        Parser::ToBinary(Data.x, RawData); RawData += sizeof(Parser::ValueType);
-        Parser::ToBinary(Data.y, RawData); RawData += sizeof(Parser::ValueType);
-        Parser::ToBinary(Data.z, RawData); RawData += sizeof(Parser::ValueType);
+        Parser::ToBinary(Data.x, RawData); RawData += sizeof(typename Parser::ValueType);
+        Parser::ToBinary(Data.y, RawData); RawData += sizeof(typename Parser::ValueType);
+        Parser::ToBinary(Data.z, RawData); RawData += sizeof(typename Parser::ValueType);
     }
 };
 
@@ -432,18 +645,23 @@ public:
 	typedef SizeType ValueType;
 	static SizeType FromString(const std::string &String)
 	{
+        ValueTree tree(String);
+        return FromTree(tree, tree.GetRoot());
+	}
+	static SizeType FromTree(const ValueTree &Tree, uint32_t ValueNode)
+	{
         typedef SizeParser<Parser, SizeType> ThisType;
-        return ParseValue<ThisType>(String, 
-            [](const std::string &Str)
+        return ParseValue<ThisType>(Tree, ValueNode, 
+            [](const ValueTree &PairTree, uint32_t PairNode)
             {
-                SerializerTools<Parser>::Pair pair = SerializerTools<Parser>::PairFromString(Str, '(', ')');
+                typename SerializerTools<Parser>::Pair pair = SerializerTools<Parser>::PairFromTree(PairTree, PairNode, '(');
                 return SizeType(pair.first, pair.second);
             }
         );
 	}
 	static std::string ToString(const SizeType &Data)
 	{		 
-		return SerializerTools<Parser>::PairToString(SerializerTools<Parser>::Pair(Data.width, Data.height), '(', ')');
+		return SerializerTools<Parser>::PairToString(typename SerializerTools<Parser>::Pair(Data.width, Data.height), '(', ')');
 	}
 	static SizeType FromBinary(const char *RawData)
 	{
@@ -452,7 +670,7 @@ public:
 	}
 	static void ToBinary(const SizeType &Data, char *RawData)
 	{		 
-		SerializerTools<Parser>::PairToBinary(SerializerTools<Parser>::Pair(Data.width, Data.height), RawData);
+		SerializerTools<Parser>::PairToBinary(typename SerializerTools<Parser>::Pair(Data.width, Data.height), RawData);
 	}
 };
 
@@ -463,20 +681,25 @@ public:
 	typedef RangeType ValueType;
 	static RangeType FromString(const std::string &String) throw (FormatException)
 	{
+        ValueTree tree(String);
+        return FromTree(tree, tree.GetRoot());
+	}
+	static RangeType FromTree(const ValueTree &Tree, uint32_t ValueNode) throw (FormatException)
+	{
         typedef RangeParser<Parser, RangeType> ThisType;
-        return ParseValue<ThisType>(String, 
-            [](const std::string &Str)
+        return ParseValue<ThisType>(Tree, ValueNode, 
+            [](const ValueTree &PairTree, uint32_t PairNode)
             {
-                SerializerTools<Parser>::Pair pair = SerializerTools<Parser>::PairFromString(Str, '(', ')');
+                typename SerializerTools<Parser>::Pair pair = SerializerTools<Parser>::PairFromTree(PairTree, PairNode, '(');
                 if(pair.first > pair.second)
-                    throw FormatException("min val is greater than max val for range " + Str);
+                    throw FormatException("min val is greater than max val for range " + PairTree.GetText(PairNode));
                 return RangeType(pair.first, pair.second);
             }
         );
 	}
 	static std::string ToString(const RangeType &Range)
 	{
-        return SerializerTools<Parser>::PairToString(SerializerTools<Parser>::Pair(Range.minVal, Range.maxVal), '(', ')');
+        return SerializerTools<Parser>::PairToString(typename SerializerTools<Parser>::Pair(Range.minVal, Range.maxVal), '(', ')');
 	}
 	static RangeType FromBinary(const char *Data)
 	{
@@ -485,22 +708,137 @@ public:
 	}
 	static void ToBinary(const RangeType &Range, char *Data) 
 	{
-		SerializerTools<Parser>::PairToBinary(SerializerTools<Parser>::Pair(Range.minVal, Range.maxVal), Data);
+		SerializerTools<Parser>::PairToBinary(typename SerializerTools<Parser>::Pair(Range.minVal, Range.maxVal), Data);
 	}
 };
 
+template<typename Parser>
+struct IsNumericParser : std::false_type {};
+
+template<typename T, class Converter>
+struct IsNumericParser<NumericParser<T, Converter> > : std::true_type {};
+
 template<typename Parser>
 class ArrayParser
 {
 public:
 	typedef typename SerializerTools<Parser>::Array ValueType;	
+	typedef typename Parser::ValueType ElementType;
+private:
+    template<class TOutput>
+    static bool TryFlatFromChars(const char *, const char *, TOutput, std::false_type)
+    {
+        return false;
+    }
+    //plain lists of numbers like (1, 2.5, 3) dont need the tree, delimiters are found by memchr
+    template<class TOutput>
+    static bool TryFlatFromChars(const char *Begin, const char *End, TOutput Output, std::true_type)
+    {
+        while(Begin != End && ValueTree::IsSpace(*Begin))
+            Begin++;
+        while(End != Begin && ValueTree::IsSpace(*(End - 1)))
+            End--;
+
+        if(End - Begin < 2 || *Begin != '(' || *(End - 1) != ')')
+            return false;
+
+        Begin++;
+        End--;
+
+        const char *elementsBegin = Begin;
+        while(elementsBegin != End && ValueTree::IsSpace(*elementsBegin))
+            elementsBegin++;
+
+        if(elementsBegin == End)
+            return true;
+
+        while(true){
+            const char *delimiter = static_cast<const char*>(memchr(Begin, ',', End - Begin));
+            const char *elementEnd = delimiter ? delimiter : End;
+
+            while(Begin != elementEnd && ValueTree::IsSpace(*Begin))
+                Begin++;
+            const char *numberEnd = elementEnd;
+            while(numberEnd != Begin && ValueTree::IsSpace(*(numberEnd - 1)))
+                numberEnd--;
+
+            ElementType value;
+            if(!Parser::TryFromChars(Begin, numberEnd, value))
+                return false;
+
+            Output(value);
+
+            if(!delimiter)
+                return true;
+
+            Begin = delimiter + 1;
+        }
+    }
+    static size_t GetElementsCount(const char *Begin, const char *End)
+    {
+        size_t count = 1;
+        for(const char *pos = Begin; (pos = static_cast<const char*>(memchr(pos, ',', End - pos))) != NULL; pos++)
+            count++;
+        return count;
+    }
+public:
 	static ValueType FromString(const std::string &String)
 	{
+        ValueType values;
+        FromString(String, values);
+        return values;
+	}
+    //memory of Values is reused
+	static void FromString(const std::string &String, ValueType &Values)
+	{
+        const char *begin = String.data(), *end = begin + String.size();
+
+        Values.clear();
+        if(IsNumericParser<Parser>::value)
+            Values.reserve(GetElementsCount(begin, end));
+        if(TryFlatFromChars(begin, end, [&Values](const ElementType &Value){Values.push_back(Value);}, IsNumericParser<Parser>()))
+            return;
+
+        ValueTree tree(String);
+        Values = FromTree(tree, tree.GetRoot());
+	}
+    //elements are written to caller memory, count of elements is returned
+	static size_t FromString(const std::string &String, ElementType *Values, size_t Capacity) throw (Exception)
+	{
+        const char *begin = String.data(), *end = begin + String.size();
+
+        size_t count = 0;
+        bool isFlat = TryFlatFromChars(begin, end, 
+            [&](const ElementType &Value)
+            {
+                if(count == Capacity)
+                    throw ArraySizeException(Utils::ToString("array ", String, " has more than ", Capacity, " elements"));
+
+                Values[count++] = Value;
+            },
+            IsNumericParser<Parser>()
+        );
+
+        if(isFlat)
+            return count;
+
+        ValueTree tree(String);
+        ValueType values = FromTree(tree, tree.GetRoot());
+        if(values.size() > Capacity)
+            throw ArraySizeException(Utils::ToString("array ", String, " has more than ", Capacity, " elements"));
+
+        for(size_t v = 0; v < values.size(); v++)
+            Values[v] = values[v];
+
+        return values.size();
+	}
+	static ValueType FromTree(const ValueTree &Tree, uint32_t ValueNode)
+	{
         typedef ArrayParser<Parser> ThisType;
-        return ParseValue<ThisType>(String, 
-            [](const std::string &Str)
+        return ParseValue<ThisType>(Tree, ValueNode, 
+            [](const ValueTree &ArrayTree, uint32_t ArrayNode)
             {
-                return SerializerTools<Parser>::ArrayFromString(Str, '(', ')', ',');
+                return SerializerTools<Parser>::ArrayFromTree(ArrayTree, ArrayNode, '(');
             }
         );
 	}
@@ -524,7 +862,12 @@ public:
 	typedef std::string ValueType;
 	static std::string FromString(const std::string &String) throw (FormatException) 
 	{
-        return ParseValue<StringParser>(String, [](const std::string &Str) -> std::string {return Str;});
+        ValueTree tree(String);
+        return FromTree(tree, tree.GetRoot());
+	}
+	static std::string FromTree(const ValueTree &Tree, uint32_t ValueNode) throw (FormatException) 
+	{
+        return ParseValue<StringParser>(Tree, ValueNode, [](const ValueTree &StringTree, uint32_t StringNode) -> std::string {return StringTree.GetText(StringNode);});
 	}
 	static std::string ToString(const std::string &String) 
 	{
@@ -532,17 +875,15 @@ public:
 	}
 	static std::string FromBinary(const char* Data)
 	{
-		std::string outString;
-		size_t size = *((size_t*)Data); Data += sizeof(size_t);
-		for(size_t i = 0; i < size; i++)
-			outString += Data[i];
-		return outString;
+		Utils::BinaryLength length;
+		memcpy(&length, Data, sizeof(length));
+		return std::string(Data + sizeof(length), Utils::FromLittleEndian(length));
 	}
 	static void ToBinary(const std::string &Value, char *OutData)
 	{
-		*((size_t*)OutData) = Value.length(); OutData += sizeof(size_t);
-		for(size_t i = 0; i <  Value.length(); i++)
-			OutData[i] = Value[i];
+		Utils::BinaryLength length = Utils::ToLittleEndian((Utils::BinaryLength)Value.length());
+		memcpy(OutData, &length, sizeof(length));
+		memcpy(OutData + sizeof(length), Value.data(), Value.length());
 	}
 };
 
@@ -553,18 +894,25 @@ public:
     typedef ColorType ValueType;
 	static ValueType FromString(const std::string &String)
 	{
-        return ParseValue<ColorParser<Parser, ValueType>>(String, 
-            [](const std::string &Str)
+        ValueTree tree(String);
+        return FromTree(tree, tree.GetRoot());
+	}
+	static ValueType FromTree(const ValueTree &Tree, uint32_t ValueNode)
+	{
+        return ParseValue<ColorParser<Parser, ValueType>>(Tree, ValueNode, 
+            [](const ValueTree &ColorTree, uint32_t ColorNode)
             {
-                ArrayParser<Parser>::ValueType arr = ArrayParser<Parser>::FromString(Str);
-                if(arr.size() != 4) 
-                    throw FormatException("invalid color syntax for string " + Str);
+                const ValueTree::Node &node = ColorTree.GetNode(ColorNode);
+                if(node.bracket != '(' || node.childrenCount != 4) 
+                    throw FormatException("invalid color syntax for string " + ColorTree.GetText(ColorNode));
+
+                uint32_t b = node.firstChild, g = ColorTree.GetNode(b).next, r = ColorTree.GetNode(g).next, a = ColorTree.GetNode(r).next;
 
                 ValueType outData;
-                outData.b = arr[0];
-                outData.g = arr[1];
-                outData.r = arr[2];
-                outData.a = arr[3];
+                outData.b = Parser::FromTree(ColorTree, b);
+                outData.g = Parser::FromTree(ColorTree, g);
+                outData.r = Parser::FromTree(ColorTree, r);
+                outData.a = Parser::FromTree(ColorTree, a);
                 return outData;
             }
         );
@@ -580,19 +928,19 @@ public:
 	}
 	static ValueType FromBinary(const char *Data)
 	{
-		Channels outData;
-		outData.b = Parser::FromBinary(Data); Data += sizeof(Parser::ValueType);
-		outData.g = Parser::FromBinary(Data); Data += sizeof(Parser::ValueType);
-		outData.r = Parser::FromBinary(Data); Data += sizeof(Parser::ValueType);
-		outData.a = Parser::FromBinary(Data); Data += sizeof(Parser::ValueType);
+		ValueType outData;
+		outData.b = Parser::FromBinary(Data); Data += sizeof(typename Parser::ValueType);
+		outData.g = Parser::FromBinary(Data); Data += sizeof(typename Parser::ValueType);
+		outData.r = Parser::FromBinary(Data); Data += sizeof(typename Parser::ValueType);
+		outData.a = Parser::FromBinary(Data); Data += sizeof(typename Parser::ValueType);
 		return outData;
 	}
 	static void ToBinary(const ValueType &Color, char *Data) 
 	{		
-		Parser::ToBinary(Color.b, Data); Data += sizeof(Parser::ValueType);
-		Parser::ToBinary(Color.g, Data); Data += sizeof(Parser::ValueType);
-		Parser::ToBinary(Color.r, Data); Data += sizeof(Parser::ValueType);
-		Parser::ToBinary(Color.a, Data); Data += sizeof(Parser::ValueType);
+		Parser::ToBinary(Color.b, Data); Data += sizeof(typename Parser::ValueType);
+		Parser::ToBinary(Color.g, Data); Data += sizeof(typename Parser::ValueType);
+		Parser::ToBinary(Color.r, Data); Data += sizeof(typename Parser::ValueType);
+		Parser::ToBinary(Color.a, Data); Data += sizeof(typename Parser::ValueType);
 	}
 };
 
@@ -623,27 +971,6 @@ typedef SizeParser<IntParser> SizeIParser;
 typedef ColorParser<UCharParser> ColorUCharParser;
 typedef ColorParser<FloatParser> ColorFParser;
 
-template<typename T>
-class BinarySerializerSize
-{
-public:
-    static size_t Get(T Var){ return sizeof(T);}
-};
-
-template<>
-class BinarySerializerSize<std::string>
-{
-public:
-    static size_t Get(const std::string &Var){ return Var.length() + sizeof(size_t);}    
-};
-
-template<typename T>
-class BinarySerializerSize<std::vector<T> >
-{
-public:
-    static size_t Get(const std::vector<T> &Var){ return Var.size() + (sizeof(T) * Var.size());}
-};
-
 template<typename T>
 struct ParserType
 {
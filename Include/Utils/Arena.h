@@ -0,0 +1,152 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <vector>
+#include <new>
+#include <limits>
+#include <utility>
+#include <cstddef>
+#include <stdint.h>
+
+namespace Utils
+{
+
+class Arena final
+{
+private:
+    struct Block
+    {
+        char *data;
+        size_t size;
+        size_t used;
+    };
+    std::vector<Block> blocks;
+    size_t blockSize;
+    Block AllocateBlock(size_t Size)
+    {
+        Block block;
+        block.data = static_cast<char*>(::operator new(Size));
+        block.size = Size;
+        block.used = 0;
+        return block;
+    }
+public:
+    Arena(const Arena &) = delete;
+    Arena &operator= (const Arena &) = delete;
+    explicit Arena(size_t BlockSize = 64 * 1024) : blockSize(BlockSize){}
+    ~Arena() { Clear();}
+    void *Allocate(size_t Size, size_t Alignment)
+    {
+        if(blocks.size()){
+            Block &block = blocks.back();
+
+            size_t offset = (block.used + Alignment - 1) & ~(Alignment - 1);
+            if(offset + Size <= block.size){
+                block.used = offset + Size;
+                return block.data + offset;
+            }
+        }
+
+        //big requests get their own block, current block stays current
+        if(Size > blockSize / 4 && blocks.size()){
+            Block big = AllocateBlock(Size);
+            big.used = Size;
+            blocks.insert(blocks.end() - 1, big);
+            return big.data;
+        }
+
+        blocks.push_back(AllocateBlock(Size > blockSize ? Size : blockSize));
+
+        Block &block = blocks.back();
+        block.used = Size;
+        return block.data;
+    }
+    void Deallocate(void *Ptr, size_t Size)
+    {
+        //only the last allocation can be given back, everything else lives until Clear
+        if(!blocks.size())
+            return;
+
+        Block &block = blocks.back();
+        if(static_cast<char*>(Ptr) + Size == block.data + block.used)
+            block.used -= Size;
+    }
+    void Clear()
+    {
+        for(size_t b = 0; b < blocks.size(); b++)
+            ::operator delete(blocks[b].data);
+
+        blocks.clear();
+    }
+    size_t GetAllocatedSize() const
+    {
+        size_t size = 0;
+        for(size_t b = 0; b < blocks.size(); b++)
+            size += blocks[b].size;
+
+        return size;
+    }
+};
+
+template<class T>
+class ArenaAllocator
+{
+template<class U> friend class ArenaAllocator;
+private:
+    Arena *arena;
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template<class U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U> other;
+    };
+    ArenaAllocator(Arena *Storage = NULL) : arena(Storage){}
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U> &Allocator) : arena(Allocator.arena){}
+    Arena *GetArena() const {return arena;}
+    T *allocate(size_t Count, const void * = NULL)
+    {
+        if(!arena)
+            return static_cast<T*>(::operator new(Count * sizeof(T)));
+
+        return static_cast<T*>(arena->Allocate(Count * sizeof(T), __alignof(T)));
+    }
+    void deallocate(T *Ptr, size_t Count)
+    {
+        if(!arena)
+            ::operator delete(Ptr);
+        else
+            arena->Deallocate(Ptr, Count * sizeof(T));
+    }
+    template<class U, class... Args>
+    void construct(U *Ptr, Args&&... Arguments)
+    {
+        ::new((void*)Ptr) U(std::forward<Args>(Arguments)...);
+    }
+    template<class U>
+    void destroy(U *Ptr)
+    {
+        Ptr->~U();
+    }
+    T *address(T &Var) const {return &Var;}
+    const T *address(const T &Var) const {return &Var;}
+    size_t max_size() const {return (std::numeric_limits<size_t>::max)() / sizeof(T);}
+    template<class U>
+    bool operator== (const ArenaAllocator<U> &Allocator) const {return arena == Allocator.arena;}
+    template<class U>
+    bool operator!= (const ArenaAllocator<U> &Allocator) const {return arena != Allocator.arena;}
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <stdint.h>
+#include <memory.h>
+#include <Exception.h>
+#include <Utils/FileGuard.h>
+#include <Utils/MappedFile.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BINARY_ARCHIVE_BIG_ENDIAN
+#endif
+
+DECLARE_EXCEPTION(BinaryArchiveException);
+
+namespace Utils
+{
+
+//archive is a header followed by values in write order, everything is little endian:
+//magic, format version, data version of the writer, lengths are 32 bit,
+//arrays are aligned to their elements from the archive begin, so they can be viewed in place
+const char BINARY_ARCHIVE_MAGIC[4] = {'T', 'T', 'B', 'A'};
+const uint32_t BINARY_ARCHIVE_VERSION = 1;
+
+struct BinaryArchiveHeader
+{
+    char magic[4];
+    uint32_t formatVersion;
+    uint32_t dataVersion;
+    uint32_t reserved;
+};
+
+typedef uint32_t BinaryLength;
+
+template<class T>
+T ToLittleEndian(T Value)
+{
+#ifdef BINARY_ARCHIVE_BIG_ENDIAN
+    char *bytes = reinterpret_cast<char*>(&Value);
+    for(size_t b = 0; b < sizeof(T) / 2; b++)
+        std::swap(bytes[b], bytes[sizeof(T) - b - 1]);
+#endif
+    return Value;
+}
+
+template<class T>
+T FromLittleEndian(T Value)
+{
+    return ToLittleEndian(Value);
+}
+
+//elements of an array in memory which is not owned by the view
+template<class T>
+class ArrayView
+{
+private:
+    const T *data = nullptr;
+    size_t size = 0;
+public:
+    ArrayView(){}
+    ArrayView(const T *Data, size_t Size) : data(Data), size(Size){}
+    const T *GetData() const {return data;}
+    size_t GetSize() const {return size;}
+    bool IsEmpty() const {return size == 0;}
+    const T &operator[] (size_t Index) const {return data[Index];}
+    const T *begin() const {return data;}
+    const T *end() const {return data + size;}
+    std::vector<T> ToVector() const {return std::vector<T>(data, data + size);}
+};
+
+class BinaryArchiveWriter final
+{
+private:
+    std::vector<char> data;
+    void Align(size_t Alignment)
+    {
+        size_t remainder = data.size() % Alignment;
+        if(remainder)
+            data.resize(data.size() + Alignment - remainder, '\0');
+    }
+public:
+    BinaryArchiveWriter(const BinaryArchiveWriter &) = delete;
+    BinaryArchiveWriter &operator= (const BinaryArchiveWriter &) = delete;
+    BinaryArchiveWriter(uint32_t DataVersion)
+    {
+        BinaryArchiveHeader header;
+        memcpy(header.magic, BINARY_ARCHIVE_MAGIC, sizeof(BINARY_ARCHIVE_MAGIC));
+        header.formatVersion = ToLittleEndian(BINARY_ARCHIVE_VERSION);
+        header.dataVersion = ToLittleEndian(DataVersion);
+        header.reserved = 0;
+
+        Write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    //space for a value written by its parser
+    char *Reserve(size_t Size)
+    {
+        size_t offset = data.size();
+        data.resize(offset + Size);
+        return data.data() + offset;
+    }
+    void Write(const char *Data, size_t Size)
+    {
+        data.insert(data.end(), Data, Data + Size);
+    }
+    template<class T>
+    void Write(const T &Value)
+    {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only numbers can be written as values");
+
+        T value = ToLittleEndian(Value);
+        Write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void WriteString(const std::string &String)
+    {
+        Write((BinaryLength)String.size());
+        Write(String.data(), String.size());
+    }
+    //structures are written as they are in memory, so their fields have to be little endian too
+    template<class T>
+    void WriteArray(const T *Data, size_t Size)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable arrays can be written");
+
+        Write((BinaryLength)Size);
+        Align(std::alignment_of<T>::value);
+
+#ifdef BINARY_ARCHIVE_BIG_ENDIAN
+        if(std::is_arithmetic<T>::value){
+            for(size_t e = 0; e < Size; e++){
+                T value = ToLittleEndian(Data[e]);
+                Write(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+            return;
+        }
+#endif
+        if(Size)
+            Write(reinterpret_cast<const char*>(Data), sizeof(T) * Size);
+    }
+    template<class T>
+    void WriteArray(const std::vector<T> &Array)
+    {
+        WriteArray(Array.data(), Array.size());
+    }
+    const std::vector<char> &GetData() const {return data;}
+    void SaveToFile(const std::string &Path) const throw (Exception)
+    {
+        FileGuard file(Path, "wb");
+
+        if(fwrite(data.data(), 1, data.size(), file.get()) != data.size())
+            throw IOException("cant write to file " + Path);
+    }
+};
+
+//reader doesnt own the data, views are valid while the data is
+class BinaryArchiveReader final
+{
+private:
+    const char *begin = nullptr, *current = nullptr, *end = nullptr;
+    uint32_t dataVersion = 0;
+    void Align(size_t Alignment) throw (BinaryArchiveException)
+    {
+        size_t remainder = (size_t)(current - begin) % Alignment;
+        if(remainder)
+            Skip(Alignment - remainder);
+    }
+public:
+    BinaryArchiveReader(const char *Data, size_t Size) throw (BinaryArchiveException) : begin(Data), current(Data), end(Data + Size)
+    {
+        BinaryArchiveHeader header;
+        memcpy(&header, Skip(sizeof(header)), sizeof(header));
+
+        if(memcmp(header.magic, BINARY_ARCHIVE_MAGIC, sizeof(BINARY_ARCHIVE_MAGIC)))
+            throw BinaryArchiveException("not a binary archive");
+
+        if(FromLittleEndian(header.formatVersion) != BINARY_ARCHIVE_VERSION)
+            throw BinaryArchiveException("unsupported binary archive version");
+
+        dataVersion = FromLittleEndian(header.dataVersion);
+    }
+    uint32_t GetDataVersion() const {return dataVersion;}
+    size_t GetRemainingSize() const {return (size_t)(end - current);}
+    bool IsEnd() const {return current == end;}
+    //data of a value read by its parser
+    const char *Skip(size_t Size) throw (BinaryArchiveException)
+    {
+        if(Size > GetRemainingSize())
+            throw BinaryArchiveException("unexpected end of binary archive");
+
+        const char *data = current;
+        current += Size;
+        return data;
+    }
+    template<class T>
+    T Read() throw (BinaryArchiveException)
+    {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only numbers can be read as values");
+
+        T value;
+        memcpy(&value, Skip(sizeof(T)), sizeof(T));
+        return FromLittleEndian(value);
+    }
+    std::string ReadString() throw (BinaryArchiveException)
+    {
+        BinaryLength length = Read<BinaryLength>();
+        return std::string(Skip(length), length);
+    }
+    //elements are not copied
+    template<class T>
+    ArrayView<T> ReadArrayView() throw (BinaryArchiveException)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable arrays can be read");
+#ifdef BINARY_ARCHIVE_BIG_ENDIAN
+        static_assert(sizeof(T) == 1 || !std::is_arithmetic<T>::value, "numbers cant be viewed on big endian hosts");
+#endif
+        BinaryLength size = Read<BinaryLength>();
+        Align(std::alignment_of<T>::value);
+
+        if(size > GetRemainingSize() / sizeof(T))
+            throw BinaryArchiveException("unexpected end of binary archive");
+
+        if((size_t)current % std::alignment_of<T>::value)
+            throw BinaryArchiveException("binary archive data is not aligned");
+
+        const T *data = reinterpret_cast<const T*>(Skip(sizeof(T) * size));
+        return ArrayView<T>(data, size);
+    }
+    template<class T>
+    void ReadArray(std::vector<T> &Array) throw (BinaryArchiveException)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable arrays can be read");
+
+        BinaryLength size = Read<BinaryLength>();
+        Align(std::alignment_of<T>::value);
+
+        if(size > GetRemainingSize() / sizeof(T))
+            throw BinaryArchiveException("unexpected end of binary archive");
+
+        Array.resize(size);
+        if(size)
+            memcpy(Array.data(), Skip(sizeof(T) * size), sizeof(T) * size);
+
+#ifdef BINARY_ARCHIVE_BIG_ENDIAN
+        if(std::is_arithmetic<T>::value)
+            for(T &element : Array)
+                element = FromLittleEndian(element);
+#endif
+    }
+};
+
+//archive in a mapped file, views point straight into the mapping
+class MappedBinaryArchive final
+{
+private:
+    MappedFile file;
+    BinaryArchiveReader reader;
+public:
+    MappedBinaryArchive(const MappedBinaryArchive &) = delete;
+    MappedBinaryArchive &operator= (const MappedBinaryArchive &) = delete;
+    MappedBinaryArchive(const std::string &Path) throw (Exception) : file(Path), reader(file.GetData(), file.GetSize()){}
+    BinaryArchiveReader &GetReader() {return reader;}
+};
+
+}
\ No newline at end of file
@@ -23,14 +23,6 @@ public:
         if(fwrite(&Var, sizeof(Var), 1, File) != 1)
             throw IOException("cant write to file " + Path);
     }
-    template<>
-    static void Write<std::string>(FILE *File, const std::string &Path, const std::string &Var)
-    {
-        for(char ch : Var)
-            Write(File, Path, ch);
-
-        Write<char>(File, Path, '\0');
-    }
     template<class TVar>
     static TVar Read(FILE *File, const std::string &Path, bool &Eof)
     {
@@ -42,11 +34,6 @@ public:
 
         return var;
     }
-    template<>
-    static std::string Read<std::string>(FILE *File, const std::string &Path, bool &Eof)
-    {
-        return ReadUntil<std::string, uint8_t>(File, Path, Eof, '\0');
-    }
     template<class TContainer, class TVar>
     static TContainer ReadUntil(FILE *File,
                                 const std::string &Path,
@@ -72,6 +59,22 @@ public:
     }
 };
 
+//specializations are out of the class, so they compile not only with MSVC
+template<>
+inline void DefaultSerialisingStrategy::Write<std::string>(FILE *File, const std::string &Path, const std::string &Var)
+{
+    for(char ch : Var)
+        Write(File, Path, ch);
+
+    Write<char>(File, Path, '\0');
+}
+
+template<>
+inline std::string DefaultSerialisingStrategy::Read<std::string>(FILE *File, const std::string &Path, bool &Eof)
+{
+    return ReadUntil<std::string, uint8_t>(File, Path, Eof, '\0');
+}
+
 template<class TStrategy>
 class BasicFileGuard final
 {
@@ -85,8 +88,14 @@ public:
     BasicFileGuard(FILE *File, const std::string &Path) : file(File), path(Path){}
     BasicFileGuard(const std::string &Path, const std::string &Mode) throw (Exception)
     {
+#ifdef _WIN32
         if(fopen_s(&file, Path.c_str(), Mode.c_str()))
             throw IOException("Cant open file " + Path);
+#else
+        file = fopen(Path.c_str(), Mode.c_str());
+        if(!file)
+            throw IOException("Cant open file " + Path);
+#endif
 
         path = Path;
     }
@@ -97,17 +106,17 @@ public:
     template<class TVar>
     TVar Read() throw (Exception)
     {
-        return TStrategy::Read<TVar>(file, path, eof);
+        return TStrategy::template Read<TVar>(file, path, eof);
     }
     template<class TContainer, class TVar>
     TContainer ReadUntil(const TVar &TerminateElement)
     {
-        return TStrategy::ReadUntil<TContainer>(file, path, eof, TerminateElement);
+        return TStrategy::template ReadUntil<TContainer>(file, path, eof, TerminateElement);
     }
     template<class TVar>
     void Write(const TVar &Var)
     {
-        TStrategy::Write<TVar>(file, path, Var);
+        TStrategy::template Write<TVar>(file, path, Var);
     }
     bool Eof() const {return eof;}
 };
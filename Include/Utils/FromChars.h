@@ -0,0 +1,290 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <string>
+#include <limits>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace Utils
+{
+
+//conversions in the manner of std::from_chars: no locale, no exceptions, no allocations
+//for usual numbers. Result points after the converted chars, NULL if chars dont start
+//with a number or the number doesnt fit into TVar. Value is changed only on success
+
+inline bool IsDigitChar(char Char)
+{
+    return Char >= '0' && Char <= '9';
+}
+
+//value of a digit in bases up to 36, 36 for other chars
+inline uint32_t GetDigitValue(char Char)
+{
+    if(Char >= '0' && Char <= '9')
+        return Char - '0';
+
+    if(Char >= 'a' && Char <= 'z')
+        return Char - 'a' + 10;
+
+    if(Char >= 'A' && Char <= 'Z')
+        return Char - 'A' + 10;
+
+    return 36;
+}
+
+template<class TVar>
+const char *FromCharsInteger(const char *Begin, const char *End, TVar &Value, uint32_t Base = 10)
+{
+    const char *pos = Begin;
+
+    bool negative = false;
+    if(pos != End && (*pos == '-' || *pos == '+')){
+        negative = *pos == '-';
+        if(negative && !std::numeric_limits<TVar>::is_signed)
+            return NULL;
+        pos++;
+    }
+
+    uint64_t limit = (uint64_t)std::numeric_limits<TVar>::max() + (negative ? 1 : 0);
+    uint64_t result = 0;
+
+    const char *digits = pos;
+    uint32_t digit;
+    for(; pos != End && (digit = GetDigitValue(*pos)) < Base; pos++){
+        if(digit > limit || result > (limit - digit) / Base)
+            return NULL;
+
+        result = result * Base + digit;
+    }
+
+    if(pos == digits)
+        return NULL;
+
+    Value = negative ? (TVar)(0 - result) : (TVar)result;
+    return pos;
+}
+
+//hex number with optional 0x prefix after the sign, as istream reads it with std::hex
+template<class TVar>
+const char *FromCharsHex(const char *Begin, const char *End, TVar &Value)
+{
+    const char *pos = Begin;
+
+    bool negative = false;
+    if(pos != End && (*pos == '-' || *pos == '+')){
+        negative = *pos == '-';
+        if(negative && !std::numeric_limits<TVar>::is_signed)
+            return NULL;
+        pos++;
+    }
+
+    if(End - pos > 2 && pos[0] == '0' && (pos[1] == 'x' || pos[1] == 'X') && GetDigitValue(pos[2]) < 16)
+        pos += 2;
+
+    if(pos == End || *pos == '-' || *pos == '+')
+        return NULL;
+
+    TVar result;
+    pos = FromCharsInteger(pos, End, result, 16);
+    if(!pos)
+        return NULL;
+
+    Value = negative ? (TVar)(0 - result) : result;
+    return pos;
+}
+
+inline double FromCharsPower(int Exponent, double)
+{
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    return powers[Exponent];
+}
+
+inline float FromCharsPower(int Exponent, float)
+{
+    static const float powers[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    return powers[Exponent];
+}
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define FROM_CHARS_EIGHT_DIGITS
+#endif
+
+//eight digits are checked and converted at once in one 64 bit number, first char is the lowest byte
+inline bool FromCharsEightDigits(const char *Chars, uint32_t &Value)
+{
+#ifdef FROM_CHARS_EIGHT_DIGITS
+    uint64_t chars;
+    memcpy(&chars, Chars, sizeof(chars));
+
+    if(((chars & 0xF0F0F0F0F0F0F0F0ULL) | (((chars + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) != 0x3333333333333333ULL)
+        return false;
+
+    chars -= 0x3030303030303030ULL;
+    chars = (chars * 10) + (chars >> 8);
+    chars = (((chars & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+             (((chars >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+
+    Value = (uint32_t)chars;
+    return true;
+#else
+    return false;
+#endif
+}
+
+//mantissa keeps 19 significant digits, runs of eight digits are taken at once while they fit
+inline bool FromCharsMantissaDigits(const char *&Pos, const char *End, uint64_t &Mantissa, int32_t &Significant)
+{
+    uint32_t digits;
+    if(Significant > 11 || End - Pos < 8 || !FromCharsEightDigits(Pos, digits))
+        return false;
+
+    Mantissa = Mantissa * 100000000 + digits;
+
+    if(Significant)
+        Significant += 8;
+    else
+        for(; digits; digits /= 10)
+            Significant++;
+
+    Pos += 8;
+    return true;
+}
+
+template<class TVar>
+const char *FromCharsFloat(const char *Begin, const char *End, TVar &Value)
+{
+    const char *pos = Begin;
+
+    bool negative = false;
+    if(pos != End && (*pos == '-' || *pos == '+')){
+        negative = *pos == '-';
+        pos++;
+    }
+
+    //first 19 significant digits fit into the mantissa, the rest only moves the exponent
+    uint64_t mantissa = 0;
+    int32_t significant = 0, exponent = 0;
+    bool anyDigit = false;
+
+    while(pos != End && IsDigitChar(*pos)){
+        anyDigit = true;
+        if(FromCharsMantissaDigits(pos, End, mantissa, significant))
+            continue;
+
+        if(significant < 19){
+            mantissa = mantissa * 10 + (*pos - '0');
+            significant += mantissa ? 1 : 0;
+        }else
+            exponent++;
+
+        pos++;
+    }
+
+    if(pos != End && *pos == '.'){
+        pos++;
+        while(pos != End && IsDigitChar(*pos)){
+            anyDigit = true;
+            if(FromCharsMantissaDigits(pos, End, mantissa, significant)){
+                exponent -= 8;
+                continue;
+            }
+
+            if(significant < 19){
+                mantissa = mantissa * 10 + (*pos - '0');
+                significant += mantissa ? 1 : 0;
+                exponent--;
+            }
+
+            pos++;
+        }
+    }
+
+    if(!anyDigit)
+        return NULL;
+
+    if(pos != End && (*pos == 'e' || *pos == 'E')){
+        const char *expPos = pos + 1;
+
+        bool expNegative = false;
+        if(expPos != End && (*expPos == '-' || *expPos == '+')){
+            expNegative = *expPos == '-';
+            expPos++;
+        }
+
+        if(expPos != End && IsDigitChar(*expPos)){
+            int32_t exp = 0;
+            for(; expPos != End && IsDigitChar(*expPos); expPos++)
+                if(exp < 100000)
+                    exp = exp * 10 + (*expPos - '0');
+
+            exponent += expNegative ? -exp : exp;
+            pos = expPos;
+        }
+    }
+
+    //mantissa and power of ten are both exact here, so one rounding gives the nearest value
+    const bool isFloat = sizeof(TVar) == sizeof(float);
+    const int32_t maxSignificant = isFloat ? 7 : 15, maxExponent = isFloat ? 10 : 22;
+
+    TVar result;
+    if(significant <= maxSignificant && exponent >= -maxExponent && exponent <= maxExponent){
+        result = (TVar)mantissa;
+        result = exponent < 0 ? result / FromCharsPower(-exponent, result) : result * FromCharsPower(exponent, result);
+        result = negative ? -result : result;
+    }else if(isFloat && significant <= 15 && exponent >= -22 && exponent <= 22){
+        //same value as the C library conversion below gives for floats, without the copy
+        double converted = (double)mantissa;
+        converted = exponent < 0 ? converted / FromCharsPower(-exponent, converted) : converted * FromCharsPower(exponent, converted);
+        result = (TVar)(negative ? -converted : converted);
+    }else{
+        //long or huge numbers are rare, C library does them on a bounded copy
+        std::string number(Begin, pos);
+        double converted = strtod(number.c_str(), NULL);
+
+        //numbers a bit above max still round to max, so the check is after rounding
+        result = (TVar)converted;
+        if(result > std::numeric_limits<TVar>::max() || result < -std::numeric_limits<TVar>::max())
+            return NULL;
+    }
+
+    Value = result;
+    return pos;
+}
+
+template<class TVar, bool IsInteger = std::numeric_limits<TVar>::is_integer>
+struct CharsConverter
+{
+    static const char *Convert(const char *Begin, const char *End, TVar &Value) {return FromCharsInteger(Begin, End, Value);}
+};
+
+template<class TVar>
+struct CharsConverter<TVar, false>
+{
+    static const char *Convert(const char *Begin, const char *End, TVar &Value) {return FromCharsFloat(Begin, End, Value);}
+};
+
+template<class TVar>
+const char *FromChars(const char *Begin, const char *End, TVar &Value)
+{
+    static_assert(std::numeric_limits<TVar>::is_specialized, "FromChars needs a numeric type");
+
+    return CharsConverter<TVar>::Convert(Begin, End, Value);
+}
+
+//whole string has to be a number
+template<class TVar>
+bool FromString(const std::string &String, TVar &Value)
+{
+    const char *end = String.data() + String.size();
+    return String.size() && FromChars(String.data(), end, Value) == end;
+}
+
+}
\ No newline at end of file
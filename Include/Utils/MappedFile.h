@@ -0,0 +1,130 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <string>
+#include <Exception.h>
+
+namespace Utils
+{
+
+class MappedFile final
+{
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int file = -1;
+#endif
+    const char *data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void Release()
+    {
+        if(data)
+            UnmapViewOfFile(data);
+
+        if(mapping)
+            CloseHandle(mapping);
+
+        if(file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+
+        data = nullptr;
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+    }
+    void Open(const std::string &Path) throw (Exception)
+    {
+        file = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if(file == INVALID_HANDLE_VALUE)
+            throw IOException("Cant open file " + Path);
+
+        LARGE_INTEGER fileSize;
+        if(!GetFileSizeEx(file, &fileSize)){
+            Release();
+            throw IOException("Cant get size of file " + Path);
+        }
+
+        size = (size_t)fileSize.QuadPart;
+
+        //empty files cant be mapped
+        if(!size)
+            return;
+
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(!mapping){
+            Release();
+            throw IOException("Cant map file " + Path);
+        }
+
+        data = reinterpret_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if(!data){
+            Release();
+            throw IOException("Cant map view of file " + Path);
+        }
+    }
+#else
+    void Release()
+    {
+        if(data)
+            munmap(const_cast<char*>(data), size);
+
+        if(file != -1)
+            close(file);
+
+        data = nullptr;
+        file = -1;
+    }
+    void Open(const std::string &Path) throw (Exception)
+    {
+        file = open(Path.c_str(), O_RDONLY);
+        if(file == -1)
+            throw IOException("Cant open file " + Path);
+
+        struct stat fileStat;
+        if(fstat(file, &fileStat)){
+            Release();
+            throw IOException("Cant get size of file " + Path);
+        }
+
+        size = (size_t)fileStat.st_size;
+
+        //empty files cant be mapped
+        if(!size)
+            return;
+
+        void *view = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if(view == MAP_FAILED){
+            Release();
+            throw IOException("Cant map file " + Path);
+        }
+
+        data = reinterpret_cast<const char*>(view);
+    }
+#endif
+public:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator= (const MappedFile &) = delete;
+    MappedFile(const std::string &Path) throw (Exception) {Open(Path);}
+    ~MappedFile() { Release();}
+    const char *GetData() const {return data;}
+    size_t GetSize() const {return size;}
+    const char *begin() const {return data;}
+    const char *end() const {return data + size;}
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <atomic>
+
+//VS2013 has no thread_local, thread variables have to be trivial
+#ifdef _MSC_VER
+#define RANDOM_THREAD_LOCAL __declspec(thread)
+#else
+#define RANDOM_THREAD_LOCAL __thread
+#endif
+
+namespace Utils
+{
+
+const uint64_t DEFAULT_RANDOM_SEED = 0x853C49E6748FEA9BULL;
+
+inline uint64_t SplitMix64(uint64_t &State)
+{
+    uint64_t z = (State += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+//xoshiro256**, same seed and stream give the same sequence on every platform
+class RandomGenerator
+{
+private:
+    uint64_t state[4];
+    static uint64_t Rotl(uint64_t X, int K)
+    {
+        return (X << K) | (X >> (64 - K));
+    }
+public:
+    RandomGenerator() = default;
+    explicit RandomGenerator(uint64_t Seed, uint64_t Stream = 0)
+    {
+        SetSeed(Seed, Stream);
+    }
+    //streams of one seed are independent sequences, e.g. one per loaded file
+    void SetSeed(uint64_t Seed, uint64_t Stream = 0)
+    {
+        uint64_t mix = Seed ^ (Stream * 0xD1B54A32D192ED03ULL);
+        for(int s = 0; s < 4; s++)
+            state[s] = SplitMix64(mix);
+    }
+    uint64_t Next()
+    {
+        uint64_t result = Rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = Rotl(state[3], 45);
+
+        return result;
+    }
+    uint32_t NextUInt32()
+    {
+        return (uint32_t)(Next() >> 32);
+    }
+    //[0, 1)
+    float NextFloat()
+    {
+        return (float)(Next() >> 40) * (1.0f / 16777216.0f);
+    }
+    double NextDouble()
+    {
+        return (double)(Next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+    //[0, Count), 0 for empty range
+    uint32_t Index(uint32_t Count)
+    {
+        return (uint32_t)(((uint64_t)NextUInt32() * Count) >> 32);
+    }
+    //[Min, Max]
+    int Int(int Min, int Max)
+    {
+        uint32_t count = (uint32_t)Max - (uint32_t)Min + 1;
+        if(!count)
+            return (int)NextUInt32();
+
+        return (int)((uint32_t)Min + Index(count));
+    }
+    //[Min, Max)
+    float Float(float Min, float Max)
+    {
+        return Min + (Max - Min) * NextFloat();
+    }
+    bool Bool()
+    {
+        return (Next() >> 63) != 0;
+    }
+    void Fill(float *Data, size_t Count, float Min, float Max)
+    {
+        float scale = (Max - Min) * (1.0f / 16777216.0f);
+        for(size_t i = 0; i < Count; i++)
+            Data[i] = Min + (float)(Next() >> 40) * scale;
+    }
+    void Fill(int *Data, size_t Count, int Min, int Max)
+    {
+        for(size_t i = 0; i < Count; i++)
+            Data[i] = Int(Min, Max);
+    }
+    template<class T>
+    void Fill(std::vector<T> &Data, T Min, T Max)
+    {
+        if(!Data.empty())
+            Fill(Data.data(), Data.size(), Min, Max);
+    }
+};
+
+template<class T>
+struct RandomSeedData
+{
+    static std::atomic<uint64_t> seed;
+    static std::atomic<uint32_t> generation;
+    static std::atomic<uint64_t> threadsCount;
+};
+
+template<class T>
+std::atomic<uint64_t> RandomSeedData<T>::seed(DEFAULT_RANDOM_SEED);
+
+template<class T>
+std::atomic<uint32_t> RandomSeedData<T>::generation(0);
+
+template<class T>
+std::atomic<uint64_t> RandomSeedData<T>::threadsCount(0);
+
+struct ThreadRandomData
+{
+    RandomGenerator generator;
+    uint32_t generation;
+    uint64_t stream;
+};
+
+//thread generators are reseeded on next use
+inline void SetRandomSeed(uint64_t Seed)
+{
+    RandomSeedData<void>::seed.store(Seed);
+    RandomSeedData<void>::generation.fetch_add(1);
+}
+
+//generator of the calling thread, no locks are taken;
+//thread streams are numbered by first use, ThreadRandomScope makes them independent of threads order
+inline RandomGenerator &GetThreadRandom()
+{
+    static RANDOM_THREAD_LOCAL ThreadRandomData data;
+
+    uint32_t generation = RandomSeedData<void>::generation.load() + 1;
+    if(data.generation != generation){
+        if(!data.stream)
+            data.stream = RandomSeedData<void>::threadsCount.fetch_add(1) + 1;
+
+        data.generator.SetSeed(RandomSeedData<void>::seed.load(), data.stream);
+        data.generation = generation;
+    }
+
+    return data.generator;
+}
+
+//thread generator is replaced by the given stream until the end of the scope
+class ThreadRandomScope final
+{
+private:
+    RandomGenerator previous;
+public:
+    ThreadRandomScope(const ThreadRandomScope &) = delete;
+    ThreadRandomScope &operator= (const ThreadRandomScope &) = delete;
+    ThreadRandomScope(uint64_t Seed, uint64_t Stream = 0) : previous(GetThreadRandom())
+    {
+        GetThreadRandom().SetSeed(Seed, Stream);
+    }
+    ~ThreadRandomScope()
+    {
+        GetThreadRandom() = previous;
+    }
+};
+
+}
\ No newline at end of file
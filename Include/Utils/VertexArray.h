@@ -13,6 +13,8 @@
 #include <Vector2.h>
 #include <MeshesFwd.h>
 
+class Matrix4x4;
+
 namespace Utils
 {
 
@@ -110,6 +112,9 @@ public:
     const Meshes::VertexMetadata &GetVertexMetadata() const {return vertexMetadata;}
     void ChangeCount(UINT NewCount);
     void Clear();
+    //element of every vertex is transformed in place in one batch
+    void TransformPoints(const std::string &SemanticName, const Matrix4x4 &Matrix, bool DevideByW = false) throw (Exception);
+    void TransformVectors(const std::string &SemanticName, const Matrix4x4 &Matrix) throw (Exception);
 };
 
 }
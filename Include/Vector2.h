@@ -10,13 +10,25 @@
 #include <vector>
 #include <Vector2Fwd.h>
 
+//value types are constexpr where the compiler can fold them, VS2013 knows neither constexpr nor noexcept;
+//MATH_CONST is for constant tables, they are plain constants there
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define MATH_CONSTEXPR
+#define MATH_CONST const
+#define MATH_NOEXCEPT throw()
+#else
+#define MATH_CONSTEXPR constexpr
+#define MATH_CONST constexpr
+#define MATH_NOEXCEPT noexcept
+#endif
+
 template<class T>
 struct BaseVector2
 {	
 	T x, y;
-	BaseVector2(float X, float Y):x(X), y(Y){}
-	BaseVector2() : x(T()), y(T()){}
-	static float Dot(const BaseVector2<T> &A, const BaseVector2<T> &B) 
+	MATH_CONSTEXPR BaseVector2(float X, float Y) MATH_NOEXCEPT : x(X), y(Y){}
+	MATH_CONSTEXPR BaseVector2() MATH_NOEXCEPT : x(T()), y(T()){}
+	static MATH_CONSTEXPR float Dot(const BaseVector2<T> &A, const BaseVector2<T> &B) MATH_NOEXCEPT
 	{
 		return A.x * B.x + A.y * B.y;
 	}	
@@ -37,59 +49,59 @@ struct BaseVector2
     {
         return V.Lenght();
     }
-	BaseVector2<T> operator + ( const BaseVector2<T> &Val) const
+	MATH_CONSTEXPR BaseVector2<T> operator + ( const BaseVector2<T> &Val) const MATH_NOEXCEPT
 	{
 		return BaseVector2<T>(x + Val.x, y + Val.y);
 	}
-    BaseVector2<T> operator + () const
+    MATH_CONSTEXPR BaseVector2<T> operator + () const MATH_NOEXCEPT
     {
         return *this;
     }
-    BaseVector2<T> operator - ( const BaseVector2<T> &Val) const
+    MATH_CONSTEXPR BaseVector2<T> operator - ( const BaseVector2<T> &Val) const MATH_NOEXCEPT
 	{
 		return BaseVector2<T>(x - Val.x, y - Val.y);
 	}
-	const BaseVector2<T> operator - () const
+	MATH_CONSTEXPR const BaseVector2<T> operator - () const MATH_NOEXCEPT
 	{
 		return BaseVector2<T>(-x, -y);
 	}
-	BaseVector2<T> operator * ( const T &Val) const
+	MATH_CONSTEXPR BaseVector2<T> operator * ( const T &Val) const MATH_NOEXCEPT
 	{
 		return BaseVector2<T>(x * Val, y * Val);
 	}
-	BaseVector2<T> operator / ( const T &Val) const
+	MATH_CONSTEXPR BaseVector2<T> operator / ( const T &Val) const MATH_NOEXCEPT
 	{
 		return BaseVector2<T>(x / Val, y / Val);
 	}
-	BaseVector2<T>& operator += ( const BaseVector2<T> &Val)
+	BaseVector2<T>& operator += ( const BaseVector2<T> &Val) MATH_NOEXCEPT
 	{
 		x += Val.x;
 		y += Val.y;
 		return *this;
 	}
-	BaseVector2<T>& operator -= ( const BaseVector2<T> &Val)
+	BaseVector2<T>& operator -= ( const BaseVector2<T> &Val) MATH_NOEXCEPT
 	{
 		x -= Val.x;
 		y -= Val.y;
 		return *this;
 	}    
-	BaseVector2<T>& operator *= ( const T &Val)
+	BaseVector2<T>& operator *= ( const T &Val) MATH_NOEXCEPT
 	{
 		x *= Val;
 		y *= Val;
 		return *this;
 	}        
-	BaseVector2<T>& operator /= ( const T &Val)
+	BaseVector2<T>& operator /= ( const T &Val) MATH_NOEXCEPT
 	{
 		x /= Val;
 		y /= Val;
 		return *this;
 	}
-	bool operator == (const BaseVector2<T> & Val) const
+	MATH_CONSTEXPR bool operator == (const BaseVector2<T> & Val) const MATH_NOEXCEPT
 	{
 		return x == Val.x && y == Val.y; 
 	}
-	bool operator != (const BaseVector2<T> & Val) const
+	MATH_CONSTEXPR bool operator != (const BaseVector2<T> & Val) const MATH_NOEXCEPT
 	{
 		return !operator == (Val);
 	}
@@ -99,20 +111,18 @@ template<class T>
 struct BaseVector3
 {
     T x = T(), y = T(), z = T();
-    BaseVector3(){}
-    BaseVector3(T X, T Y, T Z) : x(X), y(Y), z(Z){}
-    BaseVector3(const BaseVector2<T> &V, T Z) : x(V.x), y(V.y), z(Z) {}
-    static float Dot(const BaseVector3<T> &A, const BaseVector3<T> &B) 
+    MATH_CONSTEXPR BaseVector3() MATH_NOEXCEPT {}
+    MATH_CONSTEXPR BaseVector3(T X, T Y, T Z) MATH_NOEXCEPT : x(X), y(Y), z(Z){}
+    MATH_CONSTEXPR BaseVector3(const BaseVector2<T> &V, T Z) MATH_NOEXCEPT : x(V.x), y(V.y), z(Z) {}
+    static MATH_CONSTEXPR float Dot(const BaseVector3<T> &A, const BaseVector3<T> &B) MATH_NOEXCEPT
     {
         return A.x * B.x + A.y * B.y + A.z * B.z;
     }
-    static BaseVector3<T> Cross(const BaseVector3<T> &A, const BaseVector3<T> &B)
+    static MATH_CONSTEXPR BaseVector3<T> Cross(const BaseVector3<T> &A, const BaseVector3<T> &B) MATH_NOEXCEPT
     {
-        BaseVector3<T> out;
-        out.x = A.y * B.z - A.z * B.y;
-        out.y = A.z * B.x - A.x * B.z;
-        out.z = A.x * B.y - A.y * B.x;
-        return out;
+        return BaseVector3<T>(A.y * B.z - A.z * B.y,
+                              A.z * B.x - A.x * B.z,
+                              A.x * B.y - A.y * B.x);
     }
     static BaseVector3<T> Normalize(const BaseVector3<T> &In)
     {
@@ -136,63 +146,63 @@ struct BaseVector3
         y /= len;
         z /= len;
     }
-    BaseVector3<T> operator + ( const BaseVector3<T> &Val) const
+    MATH_CONSTEXPR BaseVector3<T> operator + ( const BaseVector3<T> &Val) const MATH_NOEXCEPT
     {
         return {x + Val.x, y + Val.y, z + Val.z};
     }
-    BaseVector3<T> operator + () const
+    MATH_CONSTEXPR BaseVector3<T> operator + () const MATH_NOEXCEPT
     {
         return *this;
     }
-    BaseVector3<T> operator - ( const BaseVector3<T> &Val) const
+    MATH_CONSTEXPR BaseVector3<T> operator - ( const BaseVector3<T> &Val) const MATH_NOEXCEPT
     {
         return {x - Val.x, y - Val.y, z - Val.z};
     }
-    BaseVector3<T> operator - () const
+    MATH_CONSTEXPR BaseVector3<T> operator - () const MATH_NOEXCEPT
     {
         return {-x, -y, -z};
     }
-    BaseVector3<T> operator * ( const T &Val) const
+    MATH_CONSTEXPR BaseVector3<T> operator * ( const T &Val) const MATH_NOEXCEPT
     {
         return {x * Val, y * Val, z * Val};
     }
-    BaseVector3<T> operator / ( const T &Val) const
+    MATH_CONSTEXPR BaseVector3<T> operator / ( const T &Val) const MATH_NOEXCEPT
     {
         return {x / Val, y / Val, z / Val};
     }
-    BaseVector3<T>& operator += ( const BaseVector3<T> &Val)
+    BaseVector3<T>& operator += ( const BaseVector3<T> &Val) MATH_NOEXCEPT
     {
         x += Val.x;
         y += Val.y;
         z += Val.z;
         return *this;
     }
-    BaseVector3<T>& operator -= ( const BaseVector3<T> &Val)
+    BaseVector3<T>& operator -= ( const BaseVector3<T> &Val) MATH_NOEXCEPT
     {
         x -= Val.x;
         y -= Val.y;
         z -= Val.z;
         return *this;
     }
-    BaseVector3<T>& operator *= ( const T &Val)
+    BaseVector3<T>& operator *= ( const T &Val) MATH_NOEXCEPT
     {
         x *= Val;
         y *= Val;
         z *= Val;
         return *this;
     }
-    BaseVector3<T>& operator /= ( const T &Val)
+    BaseVector3<T>& operator /= ( const T &Val) MATH_NOEXCEPT
     {
         x /= Val;
         y /= Val;
         z /= Val;
         return *this;
     }
-    bool operator == (const BaseVector3<T> & Val) const
+    MATH_CONSTEXPR bool operator == (const BaseVector3<T> & Val) const MATH_NOEXCEPT
     {
         return x == Val.x && y == Val.y && z == Val.z; 
     }
-    bool operator != (const BaseVector3<T> & Val) const
+    MATH_CONSTEXPR bool operator != (const BaseVector3<T> & Val) const MATH_NOEXCEPT
     {
         return !operator == (Val);
     }
@@ -202,84 +212,84 @@ template<class T>
 struct BasePoint2
 {
 	T x, y;
-	BasePoint2(T X, T Y) : x(X), y(Y) {}
-	BasePoint2() : x(T()), y(T()){}
-    BasePoint2(const BaseVector2<T> &V) : x(V.x), y(V.y) {}
-	BasePoint2<T> operator + ( const BasePoint2<T> &Val) const
+	MATH_CONSTEXPR BasePoint2(T X, T Y) MATH_NOEXCEPT : x(X), y(Y) {}
+	MATH_CONSTEXPR BasePoint2() MATH_NOEXCEPT : x(T()), y(T()){}
+    MATH_CONSTEXPR BasePoint2(const BaseVector2<T> &V) MATH_NOEXCEPT : x(V.x), y(V.y) {}
+	MATH_CONSTEXPR BasePoint2<T> operator + ( const BasePoint2<T> &Val) const MATH_NOEXCEPT
 	{
 		return BasePoint2<T>(x + Val.x, y + Val.y);
 	}
-    BaseVector2<T> operator - ( const BasePoint2<T> &Val) const
+    MATH_CONSTEXPR BaseVector2<T> operator - ( const BasePoint2<T> &Val) const MATH_NOEXCEPT
 	{
 		return BaseVector2<T>(x - Val.x, y - Val.y);
 	}
 
-    BasePoint2<T> operator + ( const BaseVector2<T> &Val) const
+    MATH_CONSTEXPR BasePoint2<T> operator + ( const BaseVector2<T> &Val) const MATH_NOEXCEPT
 	{
         return BaseVector2<T>(x + Val.x, y + Val.y);
 	}
-    BasePoint2<T> operator - ( const BaseVector2<T> &Val) const
+    MATH_CONSTEXPR BasePoint2<T> operator - ( const BaseVector2<T> &Val) const MATH_NOEXCEPT
 	{
         return BaseVector2<T>(x - Val.x, y - Val.y);
 	}
 
-	BasePoint2<T> operator * ( const T &Val) const
+	MATH_CONSTEXPR BasePoint2<T> operator * ( const T &Val) const MATH_NOEXCEPT
 	{
 		return BasePoint2<T>(x * Val, y * Val);
 	}
-	BasePoint2<T> operator / ( const T &Val) const
+	MATH_CONSTEXPR BasePoint2<T> operator / ( const T &Val) const MATH_NOEXCEPT
 	{
 		return BasePoint2<T>(x / Val, y / Val);
 	}
-	BasePoint2<T>& operator += ( const BasePoint2<T> &Val)
+	BasePoint2<T>& operator += ( const BasePoint2<T> &Val) MATH_NOEXCEPT
 	{
 		x += Val.x;
 		y += Val.y;
 		return *this;
 	}
-	BasePoint2<T>& operator -= ( const BasePoint2<T> &Val)
+	BasePoint2<T>& operator -= ( const BasePoint2<T> &Val) MATH_NOEXCEPT
 	{
 		x -= Val.x;
 		y -= Val.y;
 		return *this;
 	}    
-	BasePoint2<T>& operator += ( const BaseVector2<T> &Val)
+	BasePoint2<T>& operator += ( const BaseVector2<T> &Val) MATH_NOEXCEPT
 	{
 		x += Val.x;
 		y += Val.y;
 		return *this;
 	}
-	BasePoint2<T>& operator -= ( const BaseVector2<T> &Val)
+	BasePoint2<T>& operator -= ( const BaseVector2<T> &Val) MATH_NOEXCEPT
 	{
 		x -= Val.x;
 		y -= Val.y;
 		return *this;
 	}  
-	BasePoint2<T>& operator *= ( const T &Val)
+	BasePoint2<T>& operator *= ( const T &Val) MATH_NOEXCEPT
 	{
 		x *= Val;
 		y *= Val;
 		return *this;
 	}        
-	BasePoint2<T>& operator /= ( const T &Val)
+	BasePoint2<T>& operator /= ( const T &Val) MATH_NOEXCEPT
 	{
 		x /= Val;
 		y /= Val;
 		return *this;
 	}
-	bool operator == (const BasePoint2<T> & Val) const
+	MATH_CONSTEXPR bool operator == (const BasePoint2<T> & Val) const MATH_NOEXCEPT
 	{
 		return x == Val.x && y == Val.y; 
 	}
-	bool operator != (const BasePoint2<T> & Val) const
+	MATH_CONSTEXPR bool operator != (const BasePoint2<T> & Val) const MATH_NOEXCEPT
 	{
 		return !operator == (Val);
 	}
-    BasePoint2<T> operator - () const
+    MATH_CONSTEXPR BasePoint2<T> operator - () const MATH_NOEXCEPT
     {
         return BasePoint2<T>(-x, -y);
     }
-    BasePoint2<T> operator + () const
+    MATH_CONSTEXPR BasePoint2<T> operator + () const MATH_NOEXCEPT
     {
         return *this;
     }
@@ -289,89 +299,89 @@ template<class T>
 struct BasePoint3
 {
     T x = T(), y = T(), z = T();
-    BasePoint3(){}
-    BasePoint3(T X, T Y, T Z) : x(X), y(Y), z(Z){}
-    BasePoint3(const BasePoint2<T> &P, T Z) : x(P.x), y(P.y), z(Z){}
-    BasePoint3(const BaseVector3<T> &V): x(V.x), y(V.y), z(V.z){}
-    BasePoint3<T> operator + ( const BasePoint3<T> &Val) const
+    MATH_CONSTEXPR BasePoint3() MATH_NOEXCEPT {}
+    MATH_CONSTEXPR BasePoint3(T X, T Y, T Z) MATH_NOEXCEPT : x(X), y(Y), z(Z){}
+    MATH_CONSTEXPR BasePoint3(const BasePoint2<T> &P, T Z) MATH_NOEXCEPT : x(P.x), y(P.y), z(Z){}
+    MATH_CONSTEXPR BasePoint3(const BaseVector3<T> &V) MATH_NOEXCEPT : x(V.x), y(V.y), z(V.z){}
+    MATH_CONSTEXPR BasePoint3<T> operator + ( const BasePoint3<T> &Val) const MATH_NOEXCEPT
     {
         return {x + Val.x, y + Val.y, z + Val.z};
     }
-    BaseVector3<T> operator - ( const BasePoint3<T> &Val) const
+    MATH_CONSTEXPR BaseVector3<T> operator - ( const BasePoint3<T> &Val) const MATH_NOEXCEPT
     {
         return {x - Val.x, y - Val.y, z - Val.z};
     }
-    BasePoint3<T> operator + ( const BaseVector3<T> &Val) const
+    MATH_CONSTEXPR BasePoint3<T> operator + ( const BaseVector3<T> &Val) const MATH_NOEXCEPT
     {
         return {x + Val.x, y + Val.y, z + Val.z};
     }
-    BasePoint3<T> operator - ( const BaseVector3<T> &Val) const
+    MATH_CONSTEXPR BasePoint3<T> operator - ( const BaseVector3<T> &Val) const MATH_NOEXCEPT
     {
         return {x - Val.x, y - Val.y, z - Val.z};
     }
-    BasePoint3<T> operator * ( const T &Val) const
+    MATH_CONSTEXPR BasePoint3<T> operator * ( const T &Val) const MATH_NOEXCEPT
     {
         return {x * Val, y * Val, z * Val};
     }
-    BasePoint3<T> operator / ( const T &Val) const
+    MATH_CONSTEXPR BasePoint3<T> operator / ( const T &Val) const MATH_NOEXCEPT
     {
         return {x / Val, y / Val, z / Val};
     }
-    BasePoint3<T>& operator += ( const BasePoint3<T> &Val)
+    BasePoint3<T>& operator += ( const BasePoint3<T> &Val) MATH_NOEXCEPT
     {
         x += Val.x;
         y += Val.y;
         z += Val.z;
         return *this;
     }
-    BasePoint3<T>& operator -= ( const BasePoint3<T> &Val)
+    BasePoint3<T>& operator -= ( const BasePoint3<T> &Val) MATH_NOEXCEPT
     {
         x -= Val.x;
         y -= Val.y;
         z -= Val.z;
         return *this;
     }
-    BasePoint3<T>& operator += ( const BaseVector3<T> &Val)
+    BasePoint3<T>& operator += ( const BaseVector3<T> &Val) MATH_NOEXCEPT
     {
         x += Val.x;
         y += Val.y;
         z += Val.z;
         return *this;
     }
-    BasePoint3<T>& operator -= ( const BaseVector3<T> &Val)
+    BasePoint3<T>& operator -= ( const BaseVector3<T> &Val) MATH_NOEXCEPT
     {
         x -= Val.x;
         y -= Val.y;
         z -= Val.z;
         return *this;
     }
-    BasePoint3<T>& operator *= ( const T &Val)
+    BasePoint3<T>& operator *= ( const T &Val) MATH_NOEXCEPT
     {
         x *= Val;
         y *= Val;
         z *= Val;
         return *this;
     }
-    BasePoint3<T>& operator /= ( const T &Val)
+    BasePoint3<T>& operator /= ( const T &Val) MATH_NOEXCEPT
     {
         x /= Val;
         y /= Val;
         z /= Val;
         return *this;
     }
-    bool operator == (const BasePoint3<T> & Val) const
+    MATH_CONSTEXPR bool operator == (const BasePoint3<T> & Val) const MATH_NOEXCEPT
     {
         return x == Val.x && y == Val.y && z == Val.z; 
     }
-    bool operator != (const BasePoint3<T> & Val) const
+    MATH_CONSTEXPR bool operator != (const BasePoint3<T> & Val) const MATH_NOEXCEPT
     {
         return !operator == (Val);
     }
-    BasePoint3<T> operator - () const
+    MATH_CONSTEXPR BasePoint3<T> operator - () const MATH_NOEXCEPT
     {
         return {-x, -y, -z};
     }
-    BasePoint3<T> operator + () const
+    MATH_CONSTEXPR BasePoint3<T> operator + () const MATH_NOEXCEPT
     {
         return *this;
     }
@@ -381,34 +391,34 @@ template<class T>
 struct BasePoint4
 {
     T x, y, z, w;
-    BasePoint4() : x(T()), y(T()), z(T()), w(T()){}
-    BasePoint4(T X, T Y, T Z, T W) : x(X), y(Y), z(Z), w(W){}
-    BasePoint4(const BasePoint3<T> &Point, T W) : x(Point.x), y(Point.y), z(Point.z), w(W){}
-    BasePoint4<T> operator + ( const BasePoint4<T> &Val) const
+    MATH_CONSTEXPR BasePoint4() MATH_NOEXCEPT : x(T()), y(T()), z(T()), w(T()){}
+    MATH_CONSTEXPR BasePoint4(T X, T Y, T Z, T W) MATH_NOEXCEPT : x(X), y(Y), z(Z), w(W){}
+    MATH_CONSTEXPR BasePoint4(const BasePoint3<T> &Point, T W) MATH_NOEXCEPT : x(Point.x), y(Point.y), z(Point.z), w(W){}
+    MATH_CONSTEXPR BasePoint4<T> operator + ( const BasePoint4<T> &Val) const MATH_NOEXCEPT
     {
         return {x + Val.x, y + Val.y, z + Val.z, w + Val.w};
     }
-    BasePoint4<T> operator + () const
+    MATH_CONSTEXPR BasePoint4<T> operator + () const MATH_NOEXCEPT
     {
         return *this;
     }
-    BasePoint4<T> operator - ( const BasePoint4<T> &Val) const
+    MATH_CONSTEXPR BasePoint4<T> operator - ( const BasePoint4<T> &Val) const MATH_NOEXCEPT
     {
-        return {x - Val.x, y - Val.y, z - Val.z, w + Val.w};
+        return {x - Val.x, y - Val.y, z - Val.z, w - Val.w};
     }
-    BasePoint4<T> operator - () const
+    MATH_CONSTEXPR BasePoint4<T> operator - () const MATH_NOEXCEPT
     {
         return {-x, -y, -z, -w};
     }
-    BasePoint4<T> operator * ( const T &Val) const
+    MATH_CONSTEXPR BasePoint4<T> operator * ( const T &Val) const MATH_NOEXCEPT
     {
         return {x * Val, y * Val, z * Val, w * Val};
     }
-    BasePoint4<T> operator / ( const T &Val) const
+    MATH_CONSTEXPR BasePoint4<T> operator / ( const T &Val) const MATH_NOEXCEPT
     {
         return {x / Val, y / Val, z / Val, w / Val};
     }
-    BasePoint4<T>& operator += ( const BasePoint4<T> &Val)
+    BasePoint4<T>& operator += ( const BasePoint4<T> &Val) MATH_NOEXCEPT
     {
         x += Val.x;
         y += Val.y;
@@ -416,7 +426,7 @@ struct BasePoint4
         w += Val.w;
         return *this;
     }
-    BasePoint4<T>& operator -= ( const BasePoint4<T> &Val)
+    BasePoint4<T>& operator -= ( const BasePoint4<T> &Val) MATH_NOEXCEPT
     {
         x -= Val.x;
         y -= Val.y;
@@ -424,7 +434,7 @@ struct BasePoint4
         w -= Val.w;
         return *this;
     }
-    BasePoint4<T>& operator *= ( const T &Val)
+    BasePoint4<T>& operator *= ( const T &Val) MATH_NOEXCEPT
     {
         x *= Val;
         y *= Val;
@@ -432,7 +442,7 @@ struct BasePoint4
         w *= Val;
         return *this;
     }
-    BasePoint4<T>& operator /= ( const T &Val)
+    BasePoint4<T>& operator /= ( const T &Val) MATH_NOEXCEPT
     {
         x /= Val;
         y /= Val;
@@ -440,11 +450,11 @@ struct BasePoint4
         w /= Val;
         return *this;
     }
-    bool operator == (const BasePoint4<T> & Val) const
+    MATH_CONSTEXPR bool operator == (const BasePoint4<T> & Val) const MATH_NOEXCEPT
     {
         return x == Val.x && y == Val.y && z == Val.z && w == Val.w; 
     }
-    bool operator != (const BasePoint4<T> & Val) const
+    MATH_CONSTEXPR bool operator != (const BasePoint4<T> & Val) const MATH_NOEXCEPT
     {
         return !operator == (Val);
     }
@@ -454,34 +464,34 @@ template <class T>
 struct BaseColor
 {
     T r, g, b, a;
-    BaseColor() : r(T()), g(T()), b(T()), a(T()){}
-    BaseColor(T R, T G, T B, T A) : r(R), g(G), b(B), a(A){}
-    BaseColor(const BaseVector4<T> &V): r(V.x), g(V.y), b(V.z), a(V.w) {}
-    BaseColor<T> operator + ( const BaseColor<T> &Val) const
+    MATH_CONSTEXPR BaseColor() MATH_NOEXCEPT : r(T()), g(T()), b(T()), a(T()){}
+    MATH_CONSTEXPR BaseColor(T R, T G, T B, T A) MATH_NOEXCEPT : r(R), g(G), b(B), a(A){}
+    MATH_CONSTEXPR BaseColor(const BaseVector4<T> &V) MATH_NOEXCEPT : r(V.x), g(V.y), b(V.z), a(V.w) {}
+    MATH_CONSTEXPR BaseColor<T> operator + ( const BaseColor<T> &Val) const MATH_NOEXCEPT
     {
         return {r + Val.r, g + Val.g, b + Val.b, a + Val.a};
     }
-    BaseColor<T> operator + () const
+    MATH_CONSTEXPR BaseColor<T> operator + () const MATH_NOEXCEPT
     {
         return *this;
     }
-    BaseColor<T> operator - ( const BaseColor<T> &Val) const
+    MATH_CONSTEXPR BaseColor<T> operator - ( const BaseColor<T> &Val) const MATH_NOEXCEPT
     {
         return {r - Val.r, g - Val.g, b - Val.b, a - Val.a};
     }
-    BaseColor<T> operator - () const
+    MATH_CONSTEXPR BaseColor<T> operator - () const MATH_NOEXCEPT
     {
         return {-r, -g, -b, -a};
     }
-    BaseColor<T> operator * ( const T &Val) const
+    MATH_CONSTEXPR BaseColor<T> operator * ( const T &Val) const MATH_NOEXCEPT
     {
         return {r * Val, g * Val, b * Val, a * Val};
     }
-    BaseColor<T> operator / ( const T &Val) const
+    MATH_CONSTEXPR BaseColor<T> operator / ( const T &Val) const MATH_NOEXCEPT
     {
         return {r / Val, g / Val, b / Val, a / Val};
     }
-    BaseColor<T>& operator += ( const BaseColor<T> &Val)
+    BaseColor<T>& operator += ( const BaseColor<T> &Val) MATH_NOEXCEPT
     {
         r += Val.r;
         g += Val.g;
@@ -489,7 +499,7 @@ struct BaseColor
         a += Val.a;
         return *this;
     }
-    BaseColor<T>& operator -= ( const BaseColor<T> &Val)
+    BaseColor<T>& operator -= ( const BaseColor<T> &Val) MATH_NOEXCEPT
     {
         r -= Val.r;
         g -= Val.g;
@@ -497,7 +507,7 @@ struct BaseColor
         a -= Val.a;
         return *this;
     }
-    BaseColor<T>& operator *= ( const T &Val)
+    BaseColor<T>& operator *= ( const T &Val) MATH_NOEXCEPT
     {
         r *= Val.r;
         g *= Val.g;
@@ -505,7 +515,7 @@ struct BaseColor
         a *= Val.a;
         return *this;
     }
-    BaseColor<T>& operator /= ( const T &Val)
+    BaseColor<T>& operator /= ( const T &Val) MATH_NOEXCEPT
     {
         r /= Val.r;
         g /= Val.g;
@@ -513,11 +523,11 @@ struct BaseColor
         a /= Val.a;
         return *this;
     }
-    bool operator == (const BaseColor<T> & Val) const
+    MATH_CONSTEXPR bool operator == (const BaseColor<T> & Val) const MATH_NOEXCEPT
     {
         return r == Val.r && g == Val.g && b == Val.b && a == Val.a; 
     }
-    bool operator != (const BaseColor<T> & Val) const
+    MATH_CONSTEXPR bool operator != (const BaseColor<T> & Val) const MATH_NOEXCEPT
     {
         return !operator == (Val);
     }
@@ -565,53 +575,53 @@ template<class T>
 struct Size
 {
 	T width, height;
-	Size(T Width, T Height):width(Width), height(Height){}
-	Size() :width(T()), height(T()){}		
-	Size<T> operator + ( const Size<T> &Val) const
+	MATH_CONSTEXPR Size(T Width, T Height) MATH_NOEXCEPT : width(Width), height(Height){}
+	MATH_CONSTEXPR Size() MATH_NOEXCEPT : width(T()), height(T()){}		
+	MATH_CONSTEXPR Size<T> operator + ( const Size<T> &Val) const MATH_NOEXCEPT
 	{
 		return Size<T>(width + Val.width, height + Val.height);
 	}
-    Size<T> operator - ( const Size<T> &Val) const
+    MATH_CONSTEXPR Size<T> operator - ( const Size<T> &Val) const MATH_NOEXCEPT
 	{
 		return Size<T>(width - Val.width, height - Val.height);
 	}
-	Size<T> operator * ( const T &Val) const
+	MATH_CONSTEXPR Size<T> operator * ( const T &Val) const MATH_NOEXCEPT
 	{
 		return Size<T>(width * Val, height * Val);
 	}
-	Size<T> operator / ( const T &Val) const
+	MATH_CONSTEXPR Size<T> operator / ( const T &Val) const MATH_NOEXCEPT
 	{
 		return Size<T>(width / Val, height / Val);
 	}
-	Size<T>& operator += ( const Size<T> &Val)
+	Size<T>& operator += ( const Size<T> &Val) MATH_NOEXCEPT
 	{
 		width += Val.width;
 		height += Val.height;
 		return *this;
 	}
-	Size<T>& operator -= ( const Size<T> &Val)
+	Size<T>& operator -= ( const Size<T> &Val) MATH_NOEXCEPT
 	{
 		width -= Val.width;
 		height -= Val.height;
 		return *this;
 	}    
-	Size<T>& operator *= ( const T &Val)
+	Size<T>& operator *= ( const T &Val) MATH_NOEXCEPT
 	{
 		width *= Val;
 		height *= Val;
 		return *this;
 	}        
-	Size<T>& operator /= ( const T &Val)
+	Size<T>& operator /= ( const T &Val) MATH_NOEXCEPT
 	{
 		width /= Val;
 		height /= Val;
 		return *this;
 	}
-	bool operator == (const Size<T> & Val) const
+	MATH_CONSTEXPR bool operator == (const Size<T> & Val) const MATH_NOEXCEPT
 	{
 		return width == Val.width && height == Val.height; 
 	}
-	bool operator != (const Size<T> & Val) const
+	MATH_CONSTEXPR bool operator != (const Size<T> & Val) const MATH_NOEXCEPT
 	{
 		return !operator == (Val);
 	}
@@ -621,57 +631,57 @@ template <class T>
 struct Size3
 {
     T width, height, depth;
-    Size3(T Width, T Height, T Depth) : width(Width), height(Height), depth(Depth){}
-    Size3() : width(T()), height(T()), depth(T()){}
-    Size3<T> operator + ( const Size3<T> &Val) const
+    MATH_CONSTEXPR Size3(T Width, T Height, T Depth) MATH_NOEXCEPT : width(Width), height(Height), depth(Depth){}
+    MATH_CONSTEXPR Size3() MATH_NOEXCEPT : width(T()), height(T()), depth(T()){}
+    MATH_CONSTEXPR Size3<T> operator + ( const Size3<T> &Val) const MATH_NOEXCEPT
     {
         return {width + Val.width, height + Val.height, depth + Val.depth};
     }
-    Size3<T> operator - ( const Size3<T> &Val) const
+    MATH_CONSTEXPR Size3<T> operator - ( const Size3<T> &Val) const MATH_NOEXCEPT
     {
         return {width - Val.width, height - Val.height, depth - Val.depth};
     }
-    Size3<T> operator * ( const T &Val) const
+    MATH_CONSTEXPR Size3<T> operator * ( const T &Val) const MATH_NOEXCEPT
     {
-        return {width * Val, height * Val, depth * Val, depth * Val};
+        return {width * Val, height * Val, depth * Val};
     }
-    Size3<T> operator / ( const T &Val) const
+    MATH_CONSTEXPR Size3<T> operator / ( const T &Val) const MATH_NOEXCEPT
     {
         return {width / Val, height / Val, depth / Val};
     }
-    Size3<T>& operator += ( const Size3<T> &Val)
+    Size3<T>& operator += ( const Size3<T> &Val) MATH_NOEXCEPT
     {
         width += Val.width;
         height += Val.height;
         depth += Val.depth;
         return *this;
     }
-    Size3<T>& operator -= ( const Size3<T> &Val)
+    Size3<T>& operator -= ( const Size3<T> &Val) MATH_NOEXCEPT
     {
         width -= Val.width;
         height -= Val.height;
         depth -= Val.depth;
         return *this;
     }
-    Size3<T>& operator *= ( const T &Val)
+    Size3<T>& operator *= ( const T &Val) MATH_NOEXCEPT
     {
         width *= Val;
         height *= Val;
         depth *= Val;
         return *this;
     }
-    Size3<T>& operator /= ( const T &Val)
+    Size3<T>& operator /= ( const T &Val) MATH_NOEXCEPT
     {
         width /= Val;
         height /= Val;
         depth /= Val;
         return *this;
     }
-    bool operator == (const Size3<T> & Val) const
+    MATH_CONSTEXPR bool operator == (const Size3<T> & Val) const MATH_NOEXCEPT
     {
         return width == Val.width && height == Val.height && depth == Val.depth;
     }
-    bool operator != (const Size3<T> & Val) const
+    MATH_CONSTEXPR bool operator != (const Size3<T> & Val) const MATH_NOEXCEPT
     {
         return !operator == (Val);
     }
@@ -681,53 +691,53 @@ template<class T>
 struct Range
 {
 	T minVal, maxVal;
-	Range(T MinVal, T MaxVal) : minVal(MinVal), maxVal(MaxVal){}
-	Range():minVal(T()),maxVal(T()){}
-	Range<T> operator + ( const Range<T> &Val) const
+	MATH_CONSTEXPR Range(T MinVal, T MaxVal) MATH_NOEXCEPT : minVal(MinVal), maxVal(MaxVal){}
+	MATH_CONSTEXPR Range() MATH_NOEXCEPT : minVal(T()), maxVal(T()){}
+	MATH_CONSTEXPR Range<T> operator + ( const Range<T> &Val) const MATH_NOEXCEPT
 	{
 		return Range<T>(minVal + Val.minVal, maxVal + Val.maxVal);
 	}
-    Range<T> operator - ( const Range<T> &Val) const
+    MATH_CONSTEXPR Range<T> operator - ( const Range<T> &Val) const MATH_NOEXCEPT
 	{
 		return Range<T>(minVal - Val.minVal, maxVal - Val.maxVal);
 	}
-	Range<T> operator * ( const T &Val) const
+	MATH_CONSTEXPR Range<T> operator * ( const T &Val) const MATH_NOEXCEPT
 	{
 		return Range<T>(minVal * Val, maxVal * Val);
 	}
-	Range<T> operator / ( const T &Val) const
+	MATH_CONSTEXPR Range<T> operator / ( const T &Val) const MATH_NOEXCEPT
 	{
 		return Range<T>(minVal / Val, maxVal / Val);
 	}
-	Range<T>& operator += ( const Range<T> &Val)
+	Range<T>& operator += ( const Range<T> &Val) MATH_NOEXCEPT
 	{
 		minVal += Val.minVal;
 		maxVal += Val.maxVal;
 		return *this;
 	}
-	Range<T>& operator -= ( const Range<T> &Val)
+	Range<T>& operator -= ( const Range<T> &Val) MATH_NOEXCEPT
 	{
 		minVal -= Val.minVal;
 		maxVal -= Val.maxVal;
 		return *this;
 	}    
-	Range<T>& operator *= ( const T &Val)
+	Range<T>& operator *= ( const T &Val) MATH_NOEXCEPT
 	{
 		minVal *= Val;
 		maxVal *= Val;
 		return *this;
 	}        
-	Range<T>& operator /= ( const T &Val)
+	Range<T>& operator /= ( const T &Val) MATH_NOEXCEPT
 	{
 		minVal /= Val;
 		maxVal /= Val;
 		return *this;
 	}
-	bool operator == (const Range<T> & Val) const
+	MATH_CONSTEXPR bool operator == (const Range<T> & Val) const MATH_NOEXCEPT
 	{
 		return minVal == Val.minVal && maxVal == Val.maxVal; 
 	}
-	bool operator != (const Range<T> & Val) const
+	MATH_CONSTEXPR bool operator != (const Range<T> & Val) const MATH_NOEXCEPT
 	{
 		return !operator == (Val);
 	}
@@ -738,7 +748,7 @@ struct Range
         else
             return Val > minVal && Val < maxVal;
     }
-    bool Contains(const Range<T> &Val) const
+    MATH_CONSTEXPR bool Contains(const Range<T> &Val) const MATH_NOEXCEPT
     {
         return minVal < Val.minVal && maxVal > Val.maxVal;
     }
@@ -757,15 +767,15 @@ struct Rect
 {
     Size<T> size;
     BasePoint2<T> pos;
-    Rect(){}
-    Rect(const BasePoint2<T> &Pos, const Size<T> &Size)
+    MATH_CONSTEXPR Rect() MATH_NOEXCEPT {}
+    MATH_CONSTEXPR Rect(const BasePoint2<T> &Pos, const Size<T> &Size) MATH_NOEXCEPT
         : size(Size), pos(Pos) 
     {}
-    bool operator == (const Rect<T> &Val) const
+    MATH_CONSTEXPR bool operator == (const Rect<T> &Val) const MATH_NOEXCEPT
     {
         return size == Val.size && pos == Val.pos;
     }
-    bool operator != (const Rect<T> & Val) const
+    MATH_CONSTEXPR bool operator != (const Rect<T> & Val) const MATH_NOEXCEPT
     {
         return !operator == (Val);
     }
@@ -793,55 +803,55 @@ public:
 #define Pi 3.141592654f //TODO make static const float Pi 
 
 template<class T, class TVar>
-T Cast(const BaseVector2<TVar> &Val){ return T(Val.x, Val.y);}
+MATH_CONSTEXPR T Cast(const BaseVector2<TVar> &Val){ return T(Val.x, Val.y);}
 
 template<class T, class TVar>
-T Cast(const BasePoint2<TVar> &Val){ return T(Val.x, Val.y);}
+MATH_CONSTEXPR T Cast(const BasePoint2<TVar> &Val){ return T(Val.x, Val.y);}
 
 template<class T, class TVar>
-T Cast(const Size<TVar> &Val){ return T(Val.width, Val.height);}
+MATH_CONSTEXPR T Cast(const Size<TVar> &Val){ return T(Val.width, Val.height);}
 
 template<class T, class TVar>
-T Cast(const Size3<TVar> &Val){ return T(Val.width, Val.height, Val.depth);}
+MATH_CONSTEXPR T Cast(const Size3<TVar> &Val){ return T(Val.width, Val.height, Val.depth);}
 
 template<class T, class TVal>
-T Cast(const BasePoint3<TVal> &Val) {return T(Val.x, Val.y, Val.z);}
+MATH_CONSTEXPR T Cast(const BasePoint3<TVal> &Val) {return T(Val.x, Val.y, Val.z);}
 
 template <class T, class TVal>
-T Cast(const BaseVector3<TVal> &Val) {return T(Val.x, Val.y, Val.z);}
+MATH_CONSTEXPR T Cast(const BaseVector3<TVal> &Val) {return T(Val.x, Val.y, Val.z);}
 
 template <class T, class TVal>
-T Cast(const BasePoint4<TVal> &Val) {return T(Val.x, Val.y, Val.z, Val.w);}
+MATH_CONSTEXPR T Cast(const BasePoint4<TVal> &Val) {return T(Val.x, Val.y, Val.z, Val.w);}
 
 template <class T, class TVal>
-T Cast(const BaseColor<TVal> &Val) {return T(Val.r, Val.g, Val.b, Val.a);}
+MATH_CONSTEXPR T Cast(const BaseColor<TVal> &Val) {return T(Val.r, Val.g, Val.b, Val.a);}
 
 template<class T>
-inline T Cast(const Point4F &Val){ return T(Val.x, Val.y, Val.z, Val.w);}
+inline MATH_CONSTEXPR T Cast(const Point4F &Val){ return T(Val.x, Val.y, Val.z, Val.w);}
 
 template<>
-inline Vector3 Cast<Vector3>(const Point4F &Val) {return {Val.x, Val.y, Val.z};}
+inline MATH_CONSTEXPR Vector3 Cast<Vector3>(const Point4F &Val) {return {Val.x, Val.y, Val.z};}
 
 template<>
-inline Point3F Cast<Point3F>(const Point4F &Val) {return {Val.x, Val.y, Val.z};}
+inline MATH_CONSTEXPR Point3F Cast<Point3F>(const Point4F &Val) {return {Val.x, Val.y, Val.z};}
 
 template<class T>
-inline T Cast(const Point3F &Val) { return T(Val.x, Val.y, Val.z);}
+inline MATH_CONSTEXPR T Cast(const Point3F &Val) { return T(Val.x, Val.y, Val.z);}
 
 template<>
-inline Point2F Cast<Point2F>(const Point3F &Val) { return Point2F(Val.x, Val.y);}
+inline MATH_CONSTEXPR Point2F Cast<Point2F>(const Point3F &Val) { return Point2F(Val.x, Val.y);}
 
 template<>
-inline Vector2 Cast<Vector2>(const Point3F &Val) {return Vector2(Val.x, Val.y);}
+inline MATH_CONSTEXPR Vector2 Cast<Vector2>(const Point3F &Val) {return Vector2(Val.x, Val.y);}
 
 template<class T>
-inline T Cast(const Vector3 &Val) { return T(Val.x, Val.y, Val.z);}
+inline MATH_CONSTEXPR T Cast(const Vector3 &Val) { return T(Val.x, Val.y, Val.z);}
 
 template<>
-inline Point2F Cast<Point2F>(const Vector3 &Val) { return {Val.x, Val.y};}
+inline MATH_CONSTEXPR Point2F Cast<Point2F>(const Vector3 &Val) { return {Val.x, Val.y};}
 
 template<>
-inline Vector2 Cast<Vector2>(const Vector3 &Val) {return {Val.x, Val.y};}
+inline MATH_CONSTEXPR Vector2 Cast<Vector2>(const Vector3 &Val) {return {Val.x, Val.y};}
 
 template<class T>
 float Disstance(const T &Point1, const T &Point2)
@@ -7,13 +7,22 @@
 
 #pragma once
 #include <Utils/ToString.h>
+#include <Utils/Arena.h>
 #include <Exception.h>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
+#include <iterator>
+#include <memory>
 #include <cstdio>
 #include <stdint.h>
 
+namespace Utils
+{
+class MappedFile;
+}
+
 namespace XML
 {
 DECLARE_EXCEPTION(XmlException);
@@ -26,14 +35,133 @@ DECLARE_CHILD_EXCEPTION(NodeIteratorException, NodeException);
 DECLARE_CHILD_EXCEPTION(PropertyException, XmlException);
 DECLARE_CHILD_EXCEPTION(PropertyNotFoundException, PropertyException);
 DECLARE_CHILD_EXCEPTION(PropertyExistException, NodeException);
+DECLARE_CHILD_EXCEPTION(PropertyFormatException, PropertyException);
 
 DECLARE_CHILD_EXCEPTION(XmlSyntaxException, XmlException);
+DECLARE_CHILD_EXCEPTION(XmlQueryException, XmlException);
 
 class Node;
+struct DocumentContext;
 typedef std::vector<Node*> NodesSet;
 typedef std::vector<const Node*> ConstNodesSet;
-typedef std::map<std::string, NodesSet> NodesContainer;
+typedef std::vector<Node*, Utils::ArenaAllocator<Node*> > NodesGroup;
+typedef std::map<std::string, NodesGroup, std::less<std::string>, Utils::ArenaAllocator<std::pair<const std::string, NodesGroup> > > NodesContainer;
 typedef std::map<std::string, std::string> HeaderData;
+//immutable subtree, nodes attached from it copy its contents only when they are reached
+typedef std::shared_ptr<const Node> SharedNode;
+
+typedef uint32_t Atom;
+const Atom INVALID_ATOM = 0xFFFFFFFF;
+
+typedef std::pair<Atom, NodesGroup*> NodesGroupRecord;
+typedef std::vector<NodesGroupRecord, Utils::ArenaAllocator<NodesGroupRecord> > NodesAtomsIndex;
+
+class NameTable final
+{
+private:
+    std::unordered_map<std::string, Atom> atoms;
+    std::vector<const std::string*> names;
+public:
+    NameTable(const NameTable &) = delete;
+    NameTable &operator= (const NameTable &) = delete;
+    NameTable(){}
+    Atom Intern(const std::string &Name);
+    Atom Find(const std::string &Name) const;
+    const std::string &GetName(Atom NameAtom) const throw (XmlException);
+    bool IsValid(Atom NameAtom) const {return NameAtom < names.size();}
+    size_t GetSize() const {return names.size();}
+};
+
+//document wide lookup tables, rebuilt on demand after the tree was changed
+class NodeIndex final
+{
+public:
+    struct Record
+    {
+        uint32_t order;
+        uint32_t depth;
+        Node *node;
+    };
+    typedef std::vector<Record> Records;
+    typedef std::pair<Records::const_iterator, Records::const_iterator> RecordsRange;
+private:
+    typedef std::unordered_map<std::string, Records> ValuesRecords;
+    Node *root;
+    bool enabled, valid;
+    //all nodes in document order, subtree of nodes[i] ends before ends[i]
+    Records nodes;
+    std::vector<uint32_t> ends;
+    std::vector<Records> byName;
+    std::vector<ValuesRecords> byProperty;
+    void Add(Node *IndexingNode, uint32_t Depth);
+    void Rebuild();
+public:
+    NodeIndex(const NodeIndex &) = delete;
+    NodeIndex &operator= (const NodeIndex &) = delete;
+    NodeIndex() : root(NULL), enabled(false), valid(false){}
+    void SetRoot(Node *Root) {root = Root; valid = false;}
+    void Enable(bool Enabled);
+    bool IsEnabled() const {return enabled;}
+    void Invalidate() {valid = false;}
+    bool Prepare();
+    const Records &GetNodes() const {return nodes;}
+    const Records *FindByName(Atom Name) const;
+    const Records *FindByProperty(Atom PropName, const std::string &PropVal) const;
+    RecordsRange GetRange(const Node &Scope, const Records &Source) const;
+    uint32_t GetDepth(const Node &Scope) const;
+    void Select(const Node &Scope, const Records &Source, bool Recursive, NodesSet &Nodes) const;
+};
+
+//offsets of one element in the source, elements are stored in document order
+//and next is the index of the first element after the subtree
+struct ElementRange
+{
+    uint32_t contentBegin;
+    uint32_t contentEnd;
+    uint32_t end;
+    uint32_t next;
+    bool single;
+};
+
+typedef std::vector<ElementRange> ElementRanges;
+
+const uint32_t INVALID_ELEMENT = 0xFFFFFFFF;
+
+//source of a lazy document, contents of a node are parsed when they are first reached
+class LazyContent final
+{
+private:
+    std::string buffer;
+    std::unique_ptr<Utils::MappedFile> file;
+    const char *begin, *end;
+    ElementRanges elements;
+    Utils::Arena *nodesArena;
+    void ParseChildren(Node &LazyNode, uint32_t Index) throw (XmlException);
+    void ParseContent(Node &LazyNode, uint32_t Index) throw (XmlException);
+    void Validate() const throw (XmlException);
+public:
+    LazyContent(const LazyContent &) = delete;
+    LazyContent &operator= (const LazyContent &) = delete;
+    LazyContent();
+    ~LazyContent();
+    void OpenFile(const std::string &FilePath) throw (Exception);
+    void OpenString(const std::string &DataString);
+    void Load(Node &Root, HeaderData &Header, Utils::Arena *NodesArena, DocumentContext *Document) throw (XmlException);
+    void Materialize(Node &LazyNode) throw (XmlException);
+    const char *GetBegin() const {return begin;}
+    const char *GetEnd() const {return end;}
+    size_t GetElementsCount() const {return elements.size();}
+};
+
+struct DocumentContext
+{
+    NameTable names;
+    NodeIndex index;
+    LazyContent *lazy;
+    //nodes below the root are allocated from arenas of the document
+    bool arenaStorage;
+    DocumentContext() : lazy(NULL), arenaStorage(false){}
+};
 
 struct NodesNamesData
 {
@@ -50,70 +178,39 @@ class BaseNodeIterator
 {
 friend class Node;
 private:
-    TNode *owner;
-    std::string curChildNodeName;
-    int curChildNodeIndex;
-    BaseNodeIterator(TNode *Owner, const std::string &ChildNodeName, int ChildNodeIndex)
-        : owner(Owner), curChildNodeName(ChildNodeName), curChildNodeIndex(ChildNodeIndex)
-    {}
-    NodesContainer::const_iterator GetCiter() const
-    {
-        if(!owner)
-            throw NodeIteratorException("Node iterator not initialised");
-
-        if(owner->nodes.size() == 0)
-            throw NodeIteratorException("Node " + owner->GetName() + " is empty");
-
-        NodesContainer::const_iterator ci = owner->nodes.find(curChildNodeName);
-        if(ci == owner->nodes.end())
-            throw NodeIteratorException("Node " + curChildNodeName + " not found in " + owner->GetName() + " node");
-
-        return ci;
-    }
+    Node * const *position;
+    explicit BaseNodeIterator(Node * const *Position) : position(Position) {}
 public:
-    BaseNodeIterator() : owner(NULL), curChildNodeIndex(0) {}
-    BaseNodeIterator<TNode>& operator++() throw (Exception)
+    typedef std::forward_iterator_tag iterator_category;
+    typedef TNode value_type;
+    typedef ptrdiff_t difference_type;
+    typedef TNode *pointer;
+    typedef TNode &reference;
+    BaseNodeIterator() : position(NULL) {}
+    BaseNodeIterator<TNode>& operator++()
     {
-        NodesContainer::const_iterator ci = GetCiter();
-
-        const NodesSet &nodes = ci->second;
-        if(++curChildNodeIndex == nodes.size()){
-            curChildNodeIndex = 0;
-
-            NodesContainer::const_iterator tmpCi = ci;
-            if(++tmpCi != owner->nodes.end())
-                curChildNodeName = tmpCi->first;
-            else
-                curChildNodeName = "LastFor" + Utils::ToString(owner);
-        }
-
+        ++position;
         return *this;
     } 
-    BaseNodeIterator<TNode> operator++(int Val) throw (Exception)
+    BaseNodeIterator<TNode> operator++(int Val)
     {
         BaseNodeIterator<TNode> tmp = *this;
-        operator++();
+        ++position;
         return tmp;
     }
-    TNode &operator*() const throw (Exception)
+    TNode &operator*() const
     {
-        return *operator->();
+        return **position;
     }
-    TNode *operator->() const throw (Exception)
+    TNode *operator->() const
     {
-        NodesContainer::const_iterator ci = GetCiter();
-
-        const NodesSet &nodes = ci->second;
-        if(!nodes.size())
-            throw NodeIteratorException("Node " + curChildNodeName + " is empty");
-
-        return nodes[curChildNodeIndex];
+        return *position;
     }
-    bool operator==(const BaseNodeIterator<TNode> &A)
+    bool operator==(const BaseNodeIterator<TNode> &A) const
     {
-        return owner == A.owner && curChildNodeName == A.curChildNodeName && curChildNodeIndex == A.curChildNodeIndex;
+        return position == A.position;
     }
-    bool operator!=(const BaseNodeIterator<TNode> &A)
+    bool operator!=(const BaseNodeIterator<TNode> &A) const
     {
         return !operator==(A);
     }
@@ -123,56 +220,198 @@ typedef BaseNodeIterator<Node> NodeIterator;
 typedef BaseNodeIterator<const Node> ConstNodeIterator;
 
 class XmlData;
+class XmlWriter;
 class NodeCopyCreater;
-class NodeFileWriter;
-class NodeStringAppender;
 template<class TStorage>
 class NodeFinder;
+class NodeQuery;
 
 class Node final
 {
 friend class XmlData;
+friend class XmlWriter;
+friend class DocumentBuilder;
 friend class NodeCopyCreater;
-friend class NodeFileWriter;
-friend class NodeStringAppender;
 friend class NodeFinder<NodesSet>;
 friend class NodeFinder<ConstNodesSet>;
 friend class BaseNodeIterator<Node>;
 friend class BaseNodeIterator<const Node>;
+friend class NodeIndex;
+friend class NodeQuery;
+friend class LazyContent;
 private:
+    typedef std::pair<const std::string, std::string> PropertyRecord;
+    typedef std::map<std::string, std::string, std::less<std::string>, Utils::ArenaAllocator<PropertyRecord> > PropertiesStorage;
+    typedef std::pair<Atom, std::string*> PropertyAtomRecord;
+    typedef std::vector<PropertyAtomRecord, Utils::ArenaAllocator<PropertyAtomRecord> > PropertiesAtomsIndex;
+    //address of id tells converted types apart
+    template<class TVar>
+    struct ConvertedType
+    {
+        static char id;
+    };
+    class ConvertedValue
+    {
+    public:
+        virtual ~ConvertedValue(){}
+    };
+    template<class TVar>
+    class ConvertedObject : public ConvertedValue
+    {
+    public:
+        TVar value;
+        explicit ConvertedObject(const TVar &Value) : value(Value){}
+    };
+    //ints and floats are kept inline, other types are owned objects
+    struct ConvertedProperty
+    {
+        const std::string *source;
+        const void *type;
+        union
+        {
+            int32_t intValue;
+            float floatValue;
+            ConvertedValue *object;
+        };
+    };
+    typedef std::vector<ConvertedProperty, Utils::ArenaAllocator<ConvertedProperty> > ConvertedProperties;
+    Utils::Arena *arena;
+    DocumentContext *document;
     std::string name;
+    Atom nameAtom;
     std::string value;
-    typedef std::map<std::string, std::string> PropertiesStorage;
     PropertiesStorage properties;
     NodesContainer nodes;
+    //same nodes as in groups, but in document order
+    NodesGroup children;
+    //filled only for nodes owned by a document, so atom lookups never touch strings
+    PropertiesAtomsIndex propertiesAtoms;
+    NodesAtomsIndex nodesAtoms;
+    //values converted by typed getters, dropped when the property can be changed
+    mutable ConvertedProperties converted;
+    //position in the document index, valid while the index is
+    uint32_t indexOrder;
+    //element with not yet parsed contents of a lazy document
+    uint32_t lazyElement;
+    //source of value and children not copied yet, name and properties are always own
+    SharedNode sharedSource;
+    void Materialize() const
+    {
+        if(lazyElement != INVALID_ELEMENT)
+            document->lazy->Materialize(const_cast<Node&>(*this));
+        else if(sharedSource)
+            const_cast<Node*>(this)->Unshare();
+    }
+    void Unshare();
+    void AttachShared(const SharedNode &Source);
+    Node(Utils::Arena *NodesArena, DocumentContext *Document);
+    static Node *Allocate(Utils::Arena *NodesArena, DocumentContext *Document);
+    static void Free(Node *FreeingNode);
+    void Touch() {if(document) document->index.Invalidate();}
+    void AttachNode(Node *ChildNode);
+    void EraseGroup(NodesContainer::iterator Group);
+    void EraseChildren(const NodesGroup &Group);
+    void InsertProperty(const std::string &Name, const std::string &Value) throw (XmlException);
+    void InsertProperty(const std::string &Name, Atom NameAtom, const std::string &Value) throw (XmlException);
+    const NodesGroup *FindGroup(Atom NodeName) const;
+    const std::string *FindProperty(Atom PropertyName) const;
+    std::string GetAtomName(Atom NameAtom) const;
+    ConvertedProperty *FindConverted(const std::string *Source, const void *Type) const;
+    ConvertedProperty &AddConverted(const std::string *Source, const void *Type) const;
+    void ForgetConverted(const std::string *Source);
+    void ClearConverted();
+    static bool IsInlineConverted(const void *Type);
+    bool ConvertInt(const std::string &Source, int32_t &Value) const;
+    bool ConvertFloat(const std::string &Source, float &Value) const;
+    PropertyFormatException CreateFormatException(const std::string &PropertyName, const std::string &Value, const std::string &TypeName) const;
+    template<class TParser>
+    typename TParser::ValueType Convert(const std::string &Source) const
+    {
+        typedef ConvertedObject<typename TParser::ValueType> Object;
+
+        //random statements of parsers, <min,max> and {a,b}, give a new value on every read
+        if(Source.find_first_of("<{") != std::string::npos)
+            return TParser::FromString(Source);
+
+        const void *type = &ConvertedType<TParser>::id;
+        ConvertedProperty *convertedProperty = FindConverted(&Source, type);
+        if(!convertedProperty){
+            std::unique_ptr<Object> object(new Object(TParser::FromString(Source)));
+            convertedProperty = &AddConverted(&Source, type);
+            convertedProperty->object = object.release();
+        }
+
+        return static_cast<Object*>(convertedProperty->object)->value;
+    }
     void Construct(const Node &Var);
-    Node * CreateCopy();
-    void WriteToFile(FILE * File, int32_t &Level) const throw (XmlException);
-    std::string ToString(int32_t &Level) const;
+    Node * CreateCopy(Utils::Arena *NodesArena, DocumentContext *Document) const;
+    void SwapContent(Node &Var);
+    void TakeContent(Node &Var);
+    bool IsMovableTo(const DocumentContext *Document) const;
+    void Rebind(DocumentContext *Document);
 public:
-    Node(){}
+    Node() : arena(NULL), document(NULL), nameAtom(INVALID_ATOM), indexOrder(0), lazyElement(INVALID_ELEMENT){}
     ~Node();
     Node(const Node &Var);
+    //content of Var is taken over when both nodes use the same arena and the descendants of Var
+    //outlive the new owner, otherwise it is copied
+    Node(Node &&Var);
     Node &operator= (const Node &Var);
+    Node &operator= (Node &&Var);
     Node &GetNode(const std::string &NodeName, uint32_t Index = 0) throw (XmlException);
     const Node &GetNode(const std::string &NodeName, uint32_t Index = 0) const throw (XmlException);    
+    Node &GetNode(Atom NodeName, uint32_t Index = 0) throw (XmlException);
+    const Node &GetNode(Atom NodeName, uint32_t Index = 0) const throw (XmlException);
     std::string &GetProperty (const std::string &PropertyName) throw (XmlException);
     const std::string &GetProperty (const std::string &PropertyName) const throw (XmlException);    
+    std::string &GetProperty (Atom PropertyName) throw (XmlException);
+    const std::string &GetProperty (Atom PropertyName) const throw (XmlException);
+    //typed getters convert a value once and keep the result in the node, so even a const
+    //document cant be read through them from several threads at once, unlike GetProperty
+    //of a loaded one. Values with random statements are parsed again on every read
+    int32_t GetInt(const std::string &PropertyName) const throw (XmlException);
+    int32_t GetInt(Atom PropertyName) const throw (XmlException);
+    float GetFloat(const std::string &PropertyName) const throw (XmlException);
+    float GetFloat(Atom PropertyName) const throw (XmlException);
+    template<class TParser>
+    typename TParser::ValueType Get(const std::string &PropertyName) const {return Convert<TParser>(GetProperty(PropertyName));}
+    template<class TParser>
+    typename TParser::ValueType Get(Atom PropertyName) const {return Convert<TParser>(GetProperty(PropertyName));}
+    //values of one property of all children with the same name, in children order
+    void GetInts(const std::string &NodesName, const std::string &PropertyName, std::vector<int32_t> &Values) const throw (XmlException);
+    void GetInts(Atom NodesName, Atom PropertyName, std::vector<int32_t> &Values) const throw (XmlException);
+    void GetFloats(const std::string &NodesName, const std::string &PropertyName, std::vector<float> &Values) const throw (XmlException);
+    void GetFloats(Atom NodesName, Atom PropertyName, std::vector<float> &Values) const throw (XmlException);
     bool FindNode(const std::string &Name, ConstNodesSet &ConstNodes, bool Recursive = true) const;
     bool FindNode(const std::string &Name, NodesSet &Nodes, bool Recursive = true);
     bool FindNode(const std::string &PropName, const std::string &PropVal, ConstNodesSet &ConstNodes, bool Recursive = true) const;
     bool FindNode(const std::string &PropName, const std::string &PropVal, NodesSet &Nodes, bool Recursive = true);
+    bool FindNode(Atom Name, ConstNodesSet &ConstNodes, bool Recursive = true) const;
+    bool FindNode(Atom Name, NodesSet &Nodes, bool Recursive = true);
+    bool FindNode(Atom PropName, const std::string &PropVal, ConstNodesSet &ConstNodes, bool Recursive = true) const;
+    bool FindNode(Atom PropName, const std::string &PropVal, NodesSet &Nodes, bool Recursive = true);
     NodesNamesDataStorage GetNodesNames() const;
     std::vector<std::string> GetPropertiesNames() const;
     size_t GetNodesCount(const std::string &Name) const;
-    void SetName(const std::string &Name) {name = Name;}
+    size_t GetNodesCount(Atom Name) const;
+    size_t GetChildrenCount() const {Materialize(); return children.size();}
+    Node &GetChild(size_t Index) throw (XmlException);
+    const Node &GetChild(size_t Index) const throw (XmlException);
+    void SetName(const std::string &Name);
     const std::string &GetName() const { return name; }
-    void SetValue(const std::string &Value) {value = Value;}
-    const std::string &GetValue() const {return value;}
+    Atom GetNameAtom() const {return nameAtom;}
+    void SetValue(const std::string &Value) {Materialize(); value = Value;}
+    const std::string &GetValue() const {Materialize(); return value;}
     void AddProperty(const std::string &Name, const std::string &Value) throw (XmlException);
     void RemoveProperty(const std::string &Name);
-    void ClearProperties(){properties.clear();}
+    void ClearProperties(){ClearConverted(); properties.clear(); propertiesAtoms.clear(); Touch();}
     void AddNode(const Node &NewNode);
+    void AddNode(Node &&NewNode);
+    void AddNode(const SharedNode &NewNode);
+    //new empty child, built in place
+    Node &CreateNode(const std::string &Name);
+    static SharedNode Share(const Node &Source);
+    static SharedNode Share(Node &&Source);
     void RemoveNode(const std::string &Name, int32_t Ind = -1) throw (XmlException);
     void ClearNodes();
     NodeIterator begin();
@@ -181,18 +420,110 @@ public:
     ConstNodeIterator end() const;
 };
 
-class XmlData final
+template<class TVar>
+char Node::ConvertedType<TVar>::id = 0;
+
+//path over child ("a/b"), descendant ("a//b") and attribute ("*[@name='x']") steps
+class NodeQuery final
+{
+private:
+    struct Predicate
+    {
+        std::string name, value;
+        bool hasValue;
+    };
+    struct Step
+    {
+        bool descendant;
+        //empty for "*"
+        std::string name;
+        std::vector<Predicate> predicates;
+    };
+    struct BoundStep
+    {
+        Atom name;
+        std::vector<Atom> predicates;
+    };
+    std::string path;
+    std::vector<Step> steps;
+    uint64_t descendantSteps;
+    void Compile() throw (XmlException);
+    XmlQueryException CreateException(size_t Position) const;
+    bool Match(const Node &TestNode, const Step &TestStep) const;
+    bool Match(const Node &TestNode, const Step &TestStep, const BoundStep &Bound) const;
+    void Collect(Node &Context, const Step &TestStep, const BoundStep &Bound, const NodeIndex &Index, NodesSet &Nodes) const;
+    void Walk(Node &ProcessNode, uint64_t States, uint64_t Pending, NodesSet &Nodes) const;
+    void Evaluate(const Node &Context, NodesSet &Nodes) const;
+public:
+    explicit NodeQuery(const std::string &Path) throw (XmlException);
+    const std::string &GetPath() const {return path;}
+    bool Select(const Node &Context, ConstNodesSet &ConstNodes) const;
+    bool Select(Node &Context, NodesSet &Nodes) const;
+};
+
+enum LoadMode
+{
+    LOAD_MODE_BUFFERED,
+    LOAD_MODE_MAPPED,
+    //mapped, large documents are split between worker threads
+    LOAD_MODE_PARALLEL,
+    //only element bounds are scanned, nodes are parsed on first access
+    LOAD_MODE_LAZY
+};
+
+//position between two elements and names of the nodes opened there
+struct ChunkBoundary
+{
+    const char *position;
+    std::vector<std::string> path;
+};
+
+typedef std::vector<ChunkBoundary> ChunkBoundaries;
+
+class IXmlHandler
+{
+public:
+    virtual ~IXmlHandler(){}
+    virtual void OnHeader(const HeaderData &Header) {}
+    virtual void OnNodeStart(const std::string &Name) {}
+    virtual void OnProperty(const std::string &Name, const std::string &Value) {}
+    virtual void OnText(const std::string &Text) {}
+    virtual void OnNodeEnd(const std::string &Name) {}
+};
+
+class XmlReader final
 {
 private:  
     class Cursor
     {
     private:
         int coll, line;
+        const char *blockBegin, *position;
+        static void Advance(const char *Begin, const char *End, int &Line, int &Coll);
+    public:
+        Cursor() : coll(1), line(1), blockBegin(NULL), position(NULL){}
+        void BeginBlock(const char *Begin) {blockBegin = position = Begin;}
+        void EndBlock(const char *End);
+        void SetPosition(const char *Char) {position = Char + 1;}
+        void Clear(){coll = line = 1; blockBegin = position = NULL;}
+        XmlSyntaxException CreateException(const std::string &Message) const;
+    };
+    class Token
+    {
+    private:
+        const char *begin;
+        size_t length;
+        std::string buffer;
+        bool buffered;
     public:
-        Cursor() : coll(1), line(1){}
-        void ProcessChar(char Char);
-        void Clear(){coll = line = 1;}
-        XmlSyntaxException CreateException(const std::string &Message);
+        Token() : begin(NULL), length(0), buffered(false){}
+        void Append(const char *Begin, const char *End);
+        void Detach();
+        void Clear();
+        bool Empty() const {return length == 0;}
+        const char *GetData() const {return buffered ? buffer.c_str() : begin;}
+        size_t GetLength() const {return length;}
+        std::string ToString() const {return std::string(GetData(), length);}
     };
     enum State
     {
@@ -203,6 +534,7 @@ private:
     };
     State state;
     bool stringState, shieldChar, isSingleNode, nodeClosed, varAsEmptyStr;
+    bool nodeStarted, rootStarted, headerRead;
     enum HeaderState
     {
         HEADER_STATE_NOT_SET,
@@ -216,30 +548,171 @@ private:
         STRUCT_STATE_NODE_DATA
     };
     StructState structState;
-    std::string text, varName, varData;
-    std::vector<Node*> processingNodes;
+    IXmlHandler *handler;
+    Token text, varName, varData, tagName;
+    std::string nodeName, propName, propValue, textData;
+    std::vector<std::string> openedNodes;
+    size_t depth;
     HeaderData header;
-    Node *lastNode, rootNode;
     Cursor cursor;
-    void ProcessChar(char Char) throw (XmlException);
+    //spans of the properties of a tag parsed at once
+    struct TagProperty
+    {
+        const char *nameBegin, *nameEnd;
+        const char *valueBegin, *valueEnd;
+    };
+    std::vector<TagProperty> tagProperties;
+    const char *ProcessRun(const char *Begin, const char *End) throw (XmlException);
+    const char *ProcessTag(const char *Begin, const char *End) throw (XmlException);
+    void ProcessChar(const char *Char) throw (XmlException);
     void ProcessNodeDefinitionStart() throw (XmlException);
     void ProcessNodeDefinitionEnd() throw (XmlException);
-    void ProcessSlash() throw (XmlException);
-    void ProcessSpace() throw (XmlException);
-    void ProcessQuestionChar() throw (XmlException);
-    void ProcessEqualChar() throw (XmlException);
-    void Cleanup();
+    void ProcessSlash(const char *Char) throw (XmlException);
+    void ProcessSpace(const char *Char) throw (XmlException);
+    void ProcessQuestionChar(const char *Char) throw (XmlException);
+    void ProcessEqualChar(const char *Char) throw (XmlException);
+    void FlushNodeName() throw (XmlException);
+    void FlushProperty() throw (XmlException);
+    void FlushText() throw (XmlException);
+    void StartNode() throw (XmlException);
+    void OpenNode();
+    void FinishTag();
+    void DetachTokens();
+public:
+    XmlReader(const XmlReader &) = delete;
+    XmlReader &operator= (const XmlReader &) = delete;
+    XmlReader(IXmlHandler *Handler);
+    void Reset();
+    void Parse(const char *Begin, const char *End) throw (XmlException);
+    void ReadFile(const std::string &FilePath, LoadMode Mode = LOAD_MODE_BUFFERED) throw (XmlException);
+    void ReadString(const std::string &DataString) throw (XmlException);
+    size_t GetDepth() const {return depth;}
+    const std::string &GetOpenedNode(size_t Depth) const {return openedNodes[Depth];}
+    bool IsIdle() const;
+    static void FindBoundaries(const char *Begin, const char *End, size_t ChunkSize, ChunkBoundaries &Boundaries);
+    static void ScanElements(const char *Begin, const char *End, ElementRanges &Elements) throw (XmlException);
+};
+
+//writes into its own buffer, with a file the buffer is flushed every FlushSize bytes
+class XmlWriter final : public IXmlHandler
+{
+private:
+    FILE *file;
+    std::string buffer;
+    size_t flushSize;
+    int32_t indent, level;
+    bool tagOpened;
+    std::vector<std::string> openedNodes;
+    void WriteIndent() {buffer.append(level * indent, ' ');}
+    void CloseTag();
+    void FlushBuffer() throw (XmlException);
+public:
+    XmlWriter(const XmlWriter &) = delete;
+    XmlWriter &operator= (const XmlWriter &) = delete;
+    explicit XmlWriter(int32_t Indent = 4);
+    XmlWriter(FILE *File, int32_t Indent = 4, size_t FlushSize = 64 * 1024);
+    ~XmlWriter();
+    void WriteHeader(const HeaderData &Header) throw (XmlException);
+    void StartNode(const std::string &Name) throw (XmlException);
+    void WriteProperty(const std::string &Name, const std::string &Value) throw (XmlException);
+    void WriteText(const std::string &Text) throw (XmlException);
+    void EndNode() throw (XmlException);
+    void WriteNode(const Node &WritingNode) throw (XmlException);
+    void Flush() throw (XmlException);
+    const std::string &GetData() const {return buffer;}
+    std::string TakeData();
+    size_t GetDepth() const {return openedNodes.size();}
+    void OnHeader(const HeaderData &Header) {WriteHeader(Header);}
+    void OnNodeStart(const std::string &Name) {StartNode(Name);}
+    void OnProperty(const std::string &Name, const std::string &Value) {WriteProperty(Name, Value);}
+    void OnText(const std::string &Text) {WriteText(Text);}
+    void OnNodeEnd(const std::string &Name) {EndNode();}
+};
+
+//creates nodes from reader events, the first node read becomes Root
+class DocumentBuilder final : public IXmlHandler
+{
+private:
+    Node *root;
+    HeaderData *header;
+    Utils::Arena *arena;
+    DocumentContext *document;
+    std::vector<Node*> processingNodes;
+public:
+    DocumentBuilder(const DocumentBuilder &) = delete;
+    DocumentBuilder &operator= (const DocumentBuilder &) = delete;
+    DocumentBuilder(Node *Root, HeaderData *Header, Utils::Arena *NodesArena, DocumentContext *Document);
+    const std::vector<Node*> &GetProcessingNodes() const {return processingNodes;}
+    void OnHeader(const HeaderData &Header);
+    void OnNodeStart(const std::string &Name);
+    void OnProperty(const std::string &Name, const std::string &Value);
+    void OnText(const std::string &Text);
+    void OnNodeEnd(const std::string &Name);
+};
+
+struct ParsedChunk;
+
+class XmlData final
+{
+public:
+    enum StorageMode
+    {
+        STORAGE_MODE_HEAP,
+        STORAGE_MODE_ARENA
+    };
+    enum CacheMode
+    {
+        CACHE_MODE_NONE,
+        CACHE_MODE_BINARY
+    };
+private:  
+    struct CacheStamp
+    {
+        uint64_t size;
+        uint64_t time;
+    };
+    HeaderData header;
+    StorageMode storageMode;
+    CacheMode cacheMode;
+    Utils::Arena arena;
+    DocumentContext document;
+    Node rootNode;
+    std::vector<Utils::Arena*> chunksArenas;
+    std::unique_ptr<LazyContent> lazyContent;
+    void ClearStorage();
+    Utils::Arena *GetNodesArena() {return storageMode == STORAGE_MODE_ARENA ? &arena : NULL;}
+    static bool GetCacheStamp(const std::string &FilePath, CacheStamp &Stamp);
+    bool LoadFromCache(const std::string &CachePath, const CacheStamp &Stamp);
+    bool ReadCache(const char *Data, size_t Size, const CacheStamp &Stamp) throw (XmlException);
+    void SaveToCache(const std::string &CachePath, const CacheStamp &Stamp) const;
+    void LoadParallel(const char *Begin, const char *End) throw (XmlException);
+    void ParseChunks(const char *Begin, const char *End, const ChunkBoundaries &Boundaries) throw (XmlException);
+    static void ParseChunk(ParsedChunk &Chunk) throw (XmlException);
+    static void RebindNodes(Node *Root, DocumentContext *Document, const std::vector<Atom> &Atoms);
+    void LoadLazy() throw (XmlException);
 public:
-    ~XmlData(){}
-    XmlData();
-    void LoadFromFile(const std::string &FilePath) throw (XmlException);
-    void LoadFromString(const std::string &DataString) throw (XmlException);
+    XmlData(const XmlData &) = delete;
+    XmlData &operator= (const XmlData &) = delete;
+    ~XmlData(){ ClearStorage();}
+    XmlData(StorageMode Mode = STORAGE_MODE_HEAP);
+    void LoadFromFile(const std::string &FilePath, LoadMode Mode = LOAD_MODE_BUFFERED) throw (XmlException);
+    void LoadFromString(const std::string &DataString, LoadMode Mode = LOAD_MODE_BUFFERED) throw (XmlException);
     void SaveToFile(const std::string &FilePath) const throw (XmlException);
     std::string ToString() const;
     const Node &GetRoot() const { return rootNode;}
     Node &GetRoot() { return rootNode;}
     const HeaderData &GetHeaderData() const {return header;}
-    void Clear() { rootNode.ClearNodes(); header.clear();}
+    const NameTable &GetNames() const {return document.names;}
+    Atom GetAtom(const std::string &Name) const;
+    void EnableIndex(bool Enabled = true) {document.index.Enable(Enabled);}
+    bool IsIndexEnabled() const {return document.index.IsEnabled();}
+    void BuildIndex();
+    StorageMode GetStorageMode() const {return storageMode;}
+    size_t GetNodesArenaSize() const {return arena.GetAllocatedSize();}
+    void SetCacheMode(CacheMode Mode) {cacheMode = Mode;}
+    CacheMode GetCacheMode() const {return cacheMode;}
+    static std::string GetCachePath(const std::string &FilePath) {return FilePath + ".xmlb";}
+    void Clear() { ClearStorage(); header.clear();}
 };
 
 };
\ No newline at end of file
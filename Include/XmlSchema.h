@@ -0,0 +1,188 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#pragma once
+#include <Xml.h>
+#include <Serializing.h>
+
+namespace XML
+{
+
+//fields of a struct are described once with names, members and parsers:
+//
+//    const auto glyphSchema = XML::Schema<Glyph>().Field<IntParser>("id", &Glyph::id).Field<FloatParser>("x", &Glyph::x);
+//
+//every field is a separate type, so reading and writing of a record are unrolled by the compiler.
+//Field methods with Fields in the name are used by the next field of the chain
+
+template<class TStruct, class TParser, class TPrevious>
+class SchemaField;
+
+//property text as is, without choices and ranges of StringParser
+class PropertyParser : public StringParser
+{
+public:
+    static std::string FromString(const std::string &String)
+    {
+        return String;
+    }
+};
+
+template<class TStruct>
+class Schema
+{
+public:
+    typedef TStruct StructType;
+    static const size_t FieldsCount = 0;
+    template<class TParser>
+    SchemaField<TStruct, TParser, Schema<TStruct> > Field(const std::string &Name, typename TParser::ValueType TStruct::*Member) const
+    {
+        return SchemaField<TStruct, TParser, Schema<TStruct> >(*this, Name, Member);
+    }
+    void BindFields(const XmlData &, Atom *) const {}
+    void ReadFields(const Node &, TStruct &) const {}
+    void ReadFields(const Node &, const Atom *, TStruct &) const {}
+    void WriteFields(Node &, const TStruct &) const {}
+    size_t GetFieldsBinarySize(const TStruct &) const {return 0;}
+    char *WriteFieldsBinary(const TStruct &, char *Data) const {return Data;}
+    const char *ReadFieldsBinary(const char *Data, TStruct &) const {return Data;}
+};
+
+template<class TStruct, class TParser, class TPrevious>
+class SchemaField
+{
+public:
+    typedef TStruct StructType;
+    typedef typename TParser::ValueType ValueType;
+    static const size_t FieldsCount = TPrevious::FieldsCount + 1;
+    //atoms of all field names in one document
+    struct Names
+    {
+        Atom atoms[FieldsCount];
+    };
+private:
+    TPrevious previous;
+    std::string name;
+    ValueType TStruct::*member;
+    template<class TGetter>
+    void Convert(const Node &Source, TStruct &Record, TGetter Getter) const throw (XmlException)
+    {
+        const std::string &value = Getter();
+        try{
+            Record.*member = TParser::FromString(value);
+        }catch(const XmlException &){
+            throw;
+        }catch(const Exception &ex){
+            throw PropertyFormatException("Property " + name + " of node " + Source.GetName() + " has invalid value " + value + ": " + ex.What());
+        }
+    }
+public:
+    SchemaField(const TPrevious &Previous, const std::string &Name, ValueType TStruct::*Member) :
+        previous(Previous), name(Name), member(Member){}
+    template<class TNextParser>
+    SchemaField<TStruct, TNextParser, SchemaField> Field(const std::string &Name, typename TNextParser::ValueType TStruct::*Member) const
+    {
+        return SchemaField<TStruct, TNextParser, SchemaField>(*this, Name, Member);
+    }
+    void BindFields(const XmlData &Data, Atom *Atoms) const
+    {
+        previous.BindFields(Data, Atoms);
+        Atoms[FieldsCount - 1] = Data.GetAtom(name);
+    }
+    void ReadFields(const Node &Source, TStruct &Record) const throw (XmlException)
+    {
+        previous.ReadFields(Source, Record);
+        Convert(Source, Record, [&]() -> const std::string & {return Source.GetProperty(name);});
+    }
+    void ReadFields(const Node &Source, const Atom *Atoms, TStruct &Record) const throw (XmlException)
+    {
+        previous.ReadFields(Source, Atoms, Record);
+
+        Atom atom = Atoms[FieldsCount - 1];
+        if(atom == INVALID_ATOM)
+            throw PropertyNotFoundException("Property " + name + " not found");
+
+        Convert(Source, Record, [&]() -> const std::string & {return Source.GetProperty(atom);});
+    }
+    void WriteFields(Node &Destination, const TStruct &Record) const throw (XmlException)
+    {
+        previous.WriteFields(Destination, Record);
+        Destination.AddProperty(name, TParser::ToString(Record.*member));
+    }
+    size_t GetFieldsBinarySize(const TStruct &Record) const
+    {
+        return previous.GetFieldsBinarySize(Record) + BinarySerializerSize<ValueType>::Get(Record.*member);
+    }
+    char *WriteFieldsBinary(const TStruct &Record, char *Data) const
+    {
+        Data = previous.WriteFieldsBinary(Record, Data);
+        TParser::ToBinary(Record.*member, Data);
+        return Data + BinarySerializerSize<ValueType>::Get(Record.*member);
+    }
+    const char *ReadFieldsBinary(const char *Data, TStruct &Record) const
+    {
+        Data = previous.ReadFieldsBinary(Data, Record);
+        Record.*member = TParser::FromBinary(Data);
+        return Data + BinarySerializerSize<ValueType>::Get(Record.*member);
+    }
+    Names Bind(const XmlData &Data) const
+    {
+        Names names;
+        BindFields(Data, names.atoms);
+        return names;
+    }
+    void Read(const Node &Source, TStruct &Record) const throw (XmlException)
+    {
+        ReadFields(Source, Record);
+    }
+    void Read(const Node &Source, const Names &FieldsNames, TStruct &Record) const throw (XmlException)
+    {
+        ReadFields(Source, FieldsNames.atoms, Record);
+    }
+    //records of all children with the same name, in children order
+    void ReadAll(const XmlData &Data, const Node &Parent, const std::string &NodesName, std::vector<TStruct> &Records) const throw (XmlException)
+    {
+        Records.clear();
+
+        Atom nodesAtom = Data.GetAtom(NodesName);
+        if(nodesAtom == INVALID_ATOM)
+            return;
+
+        Names names = Bind(Data);
+
+        Records.reserve(Parent.GetNodesCount(nodesAtom));
+        for(const Node &child : Parent)
+            if(child.GetNameAtom() == nodesAtom){
+                Records.push_back(TStruct());
+                ReadFields(child, names.atoms, Records.back());
+            }
+    }
+    void Write(Node &Destination, const TStruct &Record) const throw (XmlException)
+    {
+        WriteFields(Destination, Record);
+    }
+    void WriteAll(Node &Parent, const std::string &NodesName, const std::vector<TStruct> &Records) const throw (XmlException)
+    {
+        for(size_t r = 0; r < Records.size(); r++)
+            WriteFields(Parent.CreateNode(NodesName), Records[r]);
+    }
+    size_t GetBinarySize(const TStruct &Record) const
+    {
+        return GetFieldsBinarySize(Record);
+    }
+    //both return position after the record
+    char *ToBinary(const TStruct &Record, char *Data) const
+    {
+        return WriteFieldsBinary(Record, Data);
+    }
+    const char *FromBinary(const char *Data, TStruct &Record) const
+    {
+        return ReadFieldsBinary(Data, Record);
+    }
+};
+
+}
\ No newline at end of file
@@ -100,12 +100,16 @@ void Application::Invalidate()
     ndc.x = -1.0f + cursorPos.x * 2.0f;
     ndc.y =  1.0f - cursorPos.y * 2.0f;
 
-    Matrix4x4 invWorlViewProj = Matrix4x4::Inverse(triangleObj.GetWorldMatrix() *
-                                                   camera.GetViewMatrix() *
-                                                   camera.GetProjMatrix());
+    //only projection needs the general inverse, view and world are rigid and affine
+    Matrix4x4 invWorlViewProj = Matrix4x4::Inverse(camera.GetProjMatrix()) *
+                                camera.GetInvViewMatrix() *
+                                Matrix4x4::InverseAffine(triangleObj.GetWorldMatrix());
 
-    Point3F eyePosL = Matrix4x4::Transform(invWorlViewProj, Point3F{ndc.x, ndc.y, 0.0f}, true);
-    Point3F cursorPtL = Matrix4x4::Transform(invWorlViewProj, Point3F{ndc.x, ndc.y, 1.0f}, true);
+    Point3F ndcPoints[2] = {{ndc.x, ndc.y, 0.0f}, {ndc.x, ndc.y, 1.0f}};
+    Matrix4x4::TransformPoints(invWorlViewProj, ndcPoints, ndcPoints, 2, true);
+
+    const Point3F &eyePosL = ndcPoints[0];
+    const Point3F &cursorPtL = ndcPoints[1];
 
     bool isCollision = false;
 
@@ -7,100 +7,27 @@
 
 #include <Xml.h>
 #include <Utils/FileGuard.h>
-#include <Utils/AutoEvent.h>
+#include <Utils/MappedFile.h>
+#include <Utils/FromChars.h>
 #include <ctype.h>
 #include <sstream>
+#include <algorithm>
 
 namespace XML
 {
 
-static void write_to_file(const std::string &String, FILE *File, int32_t Level) throw (Exception)
-{
-    std::string str = std::string(Level * 4, ' ' ) + String + "\n";
-
-    if(fwrite(str.c_str(), 1, str.length(), File) != str.length())
-        throw XmlException("cant write to file");
-}
-
-static std::string to_string(const std::string &String, int32_t Level)
-{
-    return std::string(Level * 4, ' ') + String + "\n";
-}
-
-static std::string get_propertis_string(const std::map<std::string, std::string> &Properties)
-{
-    std::string propsStr;
-
-    std::map<std::string, std::string>::const_iterator ci;
-    for(ci = Properties.begin(); ci != Properties.end(); ++ci){
-        if(ci != Properties.begin())
-            propsStr += " ";
-        propsStr += ci->first + "=\"" + ci->second + "\"";
-    }    
-    return (propsStr != "") ? " " + propsStr : propsStr;
-}
-
-static std::string header_to_string(const std::map<std::string, std::string> &HeaderData)
-{
-    return "<?xml" + get_propertis_string(HeaderData) + "?>";
-}
-
-template<class Iterator, class Function, class ContainerType = NodesSet>
-void for_each_node(Iterator First, Iterator Last, Function Func )
-{
-    while(First != Last){
-        const std::string nodesName = First->first;
-        const ContainerType &set = First->second;
-
-        typename ContainerType::const_iterator sci;
-        for(sci = set.begin(); sci != set.end(); ++sci)
-            Func(*sci);
-        ++First;
-    }
-}
-
 class NodeCopyCreater
 {
 private:
-    NodesContainer * nodes;
+    Node * owner;
 public:
-    NodeCopyCreater(NodesContainer * Nodes): nodes(Nodes) {}
-    void operator() (Node * ProcessNode)
+    NodeCopyCreater(Node * Owner): owner(Owner) {}
+    void operator() (const Node * ProcessNode)
     {
-        (*nodes)[ProcessNode->GetName()].push_back(ProcessNode->CreateCopy());
+        owner->AttachNode(ProcessNode->CreateCopy(owner->arena, owner->document));
     }
 };
 
-class NodeFileWriter
-{
-private:
-    FILE * file;
-    int32_t level;
-public:
-    NodeFileWriter(FILE * File, int32_t Level): file(File), level(Level) {}
-    void operator() (Node * ProcessNode)
-    {
-        ProcessNode->WriteToFile(file, level);
-    }
-    void operator() (const Node &ProcessNode)
-    {
-        ProcessNode.WriteToFile(file, level);
-    }
-};
-
-class NodeStringAppender
-{
-private:
-    std::string * str;
-    int32_t level;
-public:
-    NodeStringAppender(std::string * Str, int32_t Level): str(Str), level(Level){}
-    void operator() (Node * ProcessNode)
-    {
-        *str += ProcessNode->ToString(level);
-    }    
-};
-
 template<class TStorage>
 class NodeFinder
 {
@@ -108,20 +35,70 @@ private:
     TStorage *storage;
     const std::string *name;
     const std::string *propVar, *propVal;
+    Atom nameAtom, propAtom;
     bool recursive;
 public:
     NodeFinder(const std::string *Name, TStorage *Storage, bool Recursive) 
-        : name(Name), storage(Storage), recursive(Recursive), propVar(NULL), propVal(NULL)
+        : storage(Storage), name(Name), propVar(NULL), propVal(NULL), nameAtom(INVALID_ATOM), propAtom(INVALID_ATOM), recursive(Recursive)
     {}
     NodeFinder(const std::string *PropVar, const std::string *PropVal, TStorage *Storage, bool Recursive)
-        : name(NULL), storage(Storage), recursive(Recursive), propVar(PropVar), propVal(PropVal)
+        : storage(Storage), name(NULL), propVar(PropVar), propVal(PropVal), nameAtom(INVALID_ATOM), propAtom(INVALID_ATOM), recursive(Recursive)
     {}
+    NodeFinder(Atom Name, TStorage *Storage, bool Recursive) 
+        : storage(Storage), name(NULL), propVar(NULL), propVal(NULL), nameAtom(Name), propAtom(INVALID_ATOM), recursive(Recursive)
+    {}
+    NodeFinder(Atom PropVar, const std::string *PropVal, TStorage *Storage, bool Recursive)
+        : storage(Storage), name(NULL), propVar(NULL), propVal(PropVal), nameAtom(INVALID_ATOM), propAtom(PropVar), recursive(Recursive)
+    {}
+    void Run(const Node &Scope)
+    {
+        Scope.Materialize();
+
+        if(!RunIndexed(Scope))
+            std::for_each(Scope.children.begin(), Scope.children.end(), *this);
+    }
+    bool RunIndexed(const Node &Scope)
+    {
+        //direct children with the given name are exactly one group
+        if(!recursive && !propVal){
+            const NodesGroup *group = NULL;
+            if(name){
+                NodesContainer::const_iterator ci = Scope.nodes.find(*name);
+                group = (ci != Scope.nodes.end()) ? &ci->second : NULL;
+            }else
+                group = Scope.FindGroup(nameAtom);
+
+            if(group)
+                storage->insert(storage->end(), group->begin(), group->end());
+
+            return true;
+        }
+
+        DocumentContext *document = Scope.document;
+        if(!document || !document->index.Prepare())
+            return false;
+
+        const NameTable &names = document->names;
+        const NodeIndex::Records *records = NULL;
+        if(propVal)
+            records = document->index.FindByProperty(propVar ? names.Find(*propVar) : propAtom, *propVal);
+        else
+            records = document->index.FindByName(name ? names.Find(*name) : nameAtom);
+
+        if(records){
+            NodesSet findedNodes;
+            document->index.Select(Scope, *records, recursive, findedNodes);
+            storage->insert(storage->end(), findedNodes.begin(), findedNodes.end());
+        }
+
+        return true;
+    }
     void operator() (Node * ProcessNode)
     {        
         if(name){
             if(ProcessNode->name == *name)
                 storage->push_back(ProcessNode);        
-        }else{
+        }else if(propVar){
             const Node::PropertiesStorage &properties = ProcessNode->properties;
             Node::PropertiesStorage::const_iterator ci;
             for(ci = properties.begin(); ci != properties.end(); ++ci)
@@ -129,59 +106,338 @@ public:
                     storage->push_back(ProcessNode);
                     break;
                 }            
-        }
-
-        if(recursive){
-            const NodesContainer &nodes = ProcessNode->nodes;
-            for_each_node(nodes.begin(), nodes.end(), NodeFinder(*this));
-        }
+        }else if(propVal){
+            const std::string *prop = ProcessNode->FindProperty(propAtom);
+            if(prop && *prop == *propVal)
+                storage->push_back(ProcessNode);
+        }else if(nameAtom != INVALID_ATOM && ProcessNode->nameAtom == nameAtom)
+            storage->push_back(ProcessNode);
+
+        if(!recursive)
+            return;
+
+        ProcessNode->Materialize();
+        std::for_each(ProcessNode->children.begin(), ProcessNode->children.end(), NodeFinder(*this));
     }
 };
 
-Node * Node::CreateCopy()
+Atom NameTable::Intern(const std::string &Name)
+{
+    //names repeat, so the key is copied only for a new one
+    std::unordered_map<std::string, Atom>::const_iterator ci = atoms.find(Name);
+    if(ci != atoms.end())
+        return ci->second;
+
+    std::pair<std::unordered_map<std::string, Atom>::iterator, bool> res = atoms.insert(std::make_pair(Name, (Atom)names.size()));
+    names.push_back(&res.first->first);
+
+    return res.first->second;
+}
+
+Atom NameTable::Find(const std::string &Name) const
+{
+    std::unordered_map<std::string, Atom>::const_iterator ci = atoms.find(Name);
+    return (ci != atoms.end()) ? ci->second : INVALID_ATOM;
+}
+
+const std::string &NameTable::GetName(Atom NameAtom) const throw (XmlException)
+{
+    if(!IsValid(NameAtom))
+        throw XmlException("Invalid atom " + Utils::ToString(NameAtom));
+
+    return *names[NameAtom];
+}
+
+Node::Node(Utils::Arena *NodesArena, DocumentContext *Document) : 
+    arena(NodesArena),
+    document(Document),
+    nameAtom(INVALID_ATOM),
+    properties(std::less<std::string>(), PropertiesStorage::allocator_type(NodesArena)),
+    nodes(std::less<std::string>(), NodesContainer::allocator_type(NodesArena)),
+    children(NodesGroup::allocator_type(NodesArena)),
+    propertiesAtoms(PropertiesAtomsIndex::allocator_type(NodesArena)),
+    nodesAtoms(NodesAtomsIndex::allocator_type(NodesArena)),
+    converted(ConvertedProperties::allocator_type(NodesArena)),
+    indexOrder(0),
+    lazyElement(INVALID_ELEMENT)
+{}
+
+Node *Node::Allocate(Utils::Arena *NodesArena, DocumentContext *Document)
+{
+    if(!NodesArena)
+        return new Node(NULL, Document);
+
+    return new (NodesArena->Allocate(sizeof(Node), __alignof(Node))) Node(NodesArena, Document);
+}
+
+void Node::Free(Node *FreeingNode)
+{
+    if(!FreeingNode->arena){
+        delete FreeingNode;
+        return;
+    }
+
+    //arena memory is released in bulk by the owner of the arena
+    Utils::Arena *nodesArena = FreeingNode->arena;
+    FreeingNode->~Node();
+    nodesArena->Deallocate(FreeingNode, sizeof(Node));
+}
+
+void Node::AttachNode(Node *ChildNode)
+{
+    NodesContainer::iterator it = nodes.find(ChildNode->name);
+    if(it == nodes.end()){
+        it = nodes.insert(std::make_pair(ChildNode->name, NodesGroup(NodesGroup::allocator_type(arena)))).first;
+
+        if(document)
+            nodesAtoms.push_back(NodesGroupRecord(ChildNode->nameAtom, &it->second));
+    }
+
+    it->second.push_back(ChildNode);
+    children.push_back(ChildNode);
+
+    Touch();
+}
+
+void Node::InsertProperty(const std::string &Name, const std::string &Value) throw (XmlException)
+{
+    InsertProperty(Name, document ? document->names.Intern(Name) : INVALID_ATOM, Value);
+}
+
+void Node::InsertProperty(const std::string &Name, Atom NameAtom, const std::string &Value) throw (XmlException)
+{
+    std::pair<PropertiesStorage::iterator, bool> res = properties.insert(std::make_pair(Name, Value));
+    if(!res.second)
+        throw PropertyExistException(std::string("Property ") + Name + " already exist in node " + name);
+
+    if(document)
+        propertiesAtoms.push_back(PropertyAtomRecord(NameAtom, &res.first->second));
+
+    Touch();
+}
+
+const NodesGroup *Node::FindGroup(Atom NodeName) const
 {
-    Node * newNode = new Node();
-    newNode->name = name;
-    newNode->properties = properties;
+    Materialize();
 
-    for_each_node(nodes.begin(), nodes.end(), NodeCopyCreater(&newNode->nodes));
+    for(size_t g = 0; g < nodesAtoms.size(); g++)
+        if(nodesAtoms[g].first == NodeName)
+            return nodesAtoms[g].second;
+
+    return NULL;
+}
+
+const std::string *Node::FindProperty(Atom PropertyName) const
+{
+    for(size_t p = 0; p < propertiesAtoms.size(); p++)
+        if(propertiesAtoms[p].first == PropertyName)
+            return propertiesAtoms[p].second;
+
+    return NULL;
+}
+
+std::string Node::GetAtomName(Atom NameAtom) const
+{
+    return (document && document->names.IsValid(NameAtom)) ? document->names.GetName(NameAtom) : "#" + Utils::ToString(NameAtom);
+}
+
+Node * Node::CreateCopy(Utils::Arena *NodesArena, DocumentContext *Document) const
+{
+    Node * newNode = Allocate(NodesArena, Document);
+
+    //copying materializes lazy nodes, which can fail
+    try{
+        newNode->Construct(*this);
+    }catch(const Exception &){
+        Free(newNode);
+        throw;
+    }
 
     return newNode;
 }
 
 void Node::Construct(const Node &Var)
 {
-    name = Var.name;
-    properties = Var.properties;
+    SetName(Var.name);
+
+    ClearProperties();
+
+    PropertiesStorage::const_iterator ci;
+    for(ci = Var.properties.begin(); ci != Var.properties.end(); ++ci)
+        InsertProperty(ci->first, ci->second);
+
+    //contents not copied yet stay shared in the copy too
+    if(Var.sharedSource){
+        sharedSource = Var.sharedSource;
+        return;
+    }
+
+    Var.Materialize();
+
+    value = Var.value;
+
+    std::for_each(Var.children.begin(), Var.children.end(), NodeCopyCreater(this));
+}
+
+void Node::SwapContent(Node &Var)
+{
+    //names stay, they are keys of the groups in the parents
+    value.swap(Var.value);
+    properties.swap(Var.properties);
+    nodes.swap(Var.nodes);
+    children.swap(Var.children);
+    propertiesAtoms.swap(Var.propertiesAtoms);
+    nodesAtoms.swap(Var.nodesAtoms);
+    converted.swap(Var.converted);
+    sharedSource.swap(Var.sharedSource);
+    std::swap(lazyElement, Var.lazyElement);
+}
+
+void Node::TakeContent(Node &Var)
+{
+    DocumentContext *source = Var.document;
 
-    for_each_node(Var.nodes.begin(), Var.nodes.end(), NodeCopyCreater(&nodes));
+    //lazy contents are parsed only by their own document
+    if(source != document && Var.lazyElement != INVALID_ELEMENT)
+        Var.Materialize();
+
+    //old content is freed only after Var is taken, Var can be a part of it
+    Node old(arena, document);
+    old.SwapContent(*this);
+    SwapContent(Var);
+
+    SetName(Var.name);
+
+    if(source != document)
+        Rebind(document);
+
+    if(source)
+        source->index.Invalidate();
+}
+
+bool Node::IsMovableTo(const DocumentContext *Document) const
+{
+    //descendants can be in the arenas of the document even if the node itself is not
+    return !document || !document->arenaStorage || document == Document;
+}
+
+void Node::Rebind(DocumentContext *Document)
+{
+    //shared contents dont depend on the document
+    if(lazyElement != INVALID_ELEMENT)
+        Materialize();
+
+    document = Document;
+    nameAtom = document ? document->names.Intern(name) : INVALID_ATOM;
+
+    propertiesAtoms.clear();
+    nodesAtoms.clear();
+
+    if(document){
+        PropertiesStorage::iterator pit;
+        for(pit = properties.begin(); pit != properties.end(); ++pit)
+            propertiesAtoms.push_back(PropertyAtomRecord(document->names.Intern(pit->first), &pit->second));
+
+        NodesContainer::iterator nit;
+        for(nit = nodes.begin(); nit != nodes.end(); ++nit)
+            nodesAtoms.push_back(NodesGroupRecord(document->names.Intern(nit->first), &nit->second));
+    }
+
+    for(size_t c = 0; c < children.size(); c++)
+        children[c]->Rebind(Document);
+
+    Touch();
+}
+
+void Node::Unshare()
+{
+    //released first, so nodes attached below dont copy the source again
+    SharedNode source;
+    source.swap(sharedSource);
+
+    source->Materialize();
+
+    value = source->value;
+
+    //aliases keep the whole shared tree alive
+    for(size_t c = 0; c < source->children.size(); c++)
+        AttachShared(SharedNode(source, source->children[c]));
+}
+
+void Node::AttachShared(const SharedNode &Source)
+{
+    Node *newNode = Allocate(arena, document);
+    newNode->SetName(Source->name);
+
+    PropertiesStorage::const_iterator ci;
+    for(ci = Source->properties.begin(); ci != Source->properties.end(); ++ci)
+        newNode->InsertProperty(ci->first, ci->second);
+
+    newNode->sharedSource = Source;
+
+    AttachNode(newNode);
 }
 
 Node::~Node()
 {
-    for_each_node(nodes.begin(), nodes.end(), [&](Node * ProcessNode) { delete ProcessNode;} );
+    ClearConverted();
+    std::for_each(children.begin(), children.end(), Free);
 }
 
-Node::Node(const Node &Var)
+Node::Node(const Node &Var) : arena(NULL), document(NULL), nameAtom(INVALID_ATOM), indexOrder(0), lazyElement(INVALID_ELEMENT)
 {
-    Construct(Var);
+    try{
+        Construct(Var);
+    }catch(const Exception &){
+        ClearNodes();
+        throw;
+    }
+}
+
+Node::Node(Node &&Var) : arena(NULL), document(NULL), nameAtom(INVALID_ATOM), indexOrder(0), lazyElement(INVALID_ELEMENT)
+{
+    //nodes from an arena cant outlive it
+    if(!Var.arena && Var.IsMovableTo(document))
+        TakeContent(Var);
+    else
+        *this = Var;
 }
 
 Node &Node::operator= (const Node &Var)
 {
-    if(this != &Var)
-        Construct(Var);
+    if(this == &Var)
+        return *this;
+
+    //Var can be a part of the old content, so it is copied first
+    Node copy(arena, document);
+    copy.Construct(Var);
+    TakeContent(copy);
+
+    return *this;
+}
+
+Node &Node::operator= (Node &&Var)
+{
+    if(this == &Var)
+        return *this;
+
+    if(arena == Var.arena && Var.IsMovableTo(document))
+        TakeContent(Var);
+    else
+        *this = Var;
 
     return *this;
 }
 
 Node &Node::GetNode(const std::string &NodeName, uint32_t Index) throw (XmlException)
 {
+    Materialize();
+
     NodesContainer::iterator it = nodes.find(NodeName);
     if(it == nodes.end())
         throw NodeNotFoundException(std::string("Node ") + NodeName + " not found");
 
-    NodesSet &set = it->second;
+    NodesGroup &set = it->second;
 
     if(Index >= set.size())
         throw NodeNotFoundException("Invalid index for node " + NodeName);
@@ -191,11 +447,13 @@ Node &Node::GetNode(const std::string &NodeName, uint32_t Index) throw (XmlExcep
 
 const Node &Node::GetNode(const std::string &NodeName, uint32_t Index) const throw (XmlException)
 {
+    Materialize();
+
     NodesContainer::const_iterator ci = nodes.find(NodeName);
     if(ci == nodes.end())
         throw NodeNotFoundException(std::string("Node ") + NodeName + " not found");
 
-    const NodesSet &set = ci->second;
+    const NodesGroup &set = ci->second;
 
     if(Index >= set.size())
         throw NodeNotFoundException("Invalid index for node " + NodeName);
@@ -203,12 +461,33 @@ const Node &Node::GetNode(const std::string &NodeName, uint32_t Index) const thr
     return *set[Index];
 }
 
+Node &Node::GetNode(Atom NodeName, uint32_t Index) throw (XmlException)
+{
+    return const_cast<Node&>(static_cast<const Node*>(this)->GetNode(NodeName, Index));
+}
+
+const Node &Node::GetNode(Atom NodeName, uint32_t Index) const throw (XmlException)
+{
+    const NodesGroup *set = FindGroup(NodeName);
+    if(!set)
+        throw NodeNotFoundException(std::string("Node ") + GetAtomName(NodeName) + " not found");
+
+    if(Index >= set->size())
+        throw NodeNotFoundException("Invalid index for node " + GetAtomName(NodeName));
+
+    return *(*set)[Index];
+}
+
 std::string &Node::GetProperty(const std::string &PropertyName) throw (XmlException)
 {
     PropertiesStorage::iterator it = properties.find(PropertyName);
     if(it == properties.end())
         throw PropertyNotFoundException(std::string("Property ") + PropertyName + " not found");
 
+    //value can be changed through the reference
+    ForgetConverted(&it->second);
+    Touch();
+
     return it->second;
 }
 
@@ -221,11 +500,193 @@ const std::string &Node::GetProperty(const std::string &PropertyName) const thro
     return ci->second;
 }
 
+std::string &Node::GetProperty(Atom PropertyName) throw (XmlException)
+{
+    std::string &prop = const_cast<std::string&>(static_cast<const Node*>(this)->GetProperty(PropertyName));
+    ForgetConverted(&prop);
+    Touch();
+
+    return prop;
+}
+
+const std::string &Node::GetProperty(Atom PropertyName) const throw (XmlException)
+{
+    const std::string *prop = FindProperty(PropertyName);
+    if(!prop)
+        throw PropertyNotFoundException(std::string("Property ") + GetAtomName(PropertyName) + " not found");
+
+    return *prop;
+}
+
+Node::ConvertedProperty *Node::FindConverted(const std::string *Source, const void *Type) const
+{
+    for(size_t c = 0; c < converted.size(); c++)
+        if(converted[c].source == Source && converted[c].type == Type)
+            return &converted[c];
+
+    return NULL;
+}
+
+Node::ConvertedProperty &Node::AddConverted(const std::string *Source, const void *Type) const
+{
+    ConvertedProperty convertedProperty;
+    convertedProperty.source = Source;
+    convertedProperty.type = Type;
+    convertedProperty.object = NULL;
+
+    converted.push_back(convertedProperty);
+    return converted.back();
+}
+
+bool Node::IsInlineConverted(const void *Type)
+{
+    return Type == &ConvertedType<int32_t>::id || Type == &ConvertedType<float>::id;
+}
+
+void Node::ForgetConverted(const std::string *Source)
+{
+    for(size_t c = converted.size(); c > 0; c--)
+        if(converted[c - 1].source == Source){
+            if(!IsInlineConverted(converted[c - 1].type))
+                delete converted[c - 1].object;
+
+            converted.erase(converted.begin() + (c - 1));
+        }
+}
+
+void Node::ClearConverted()
+{
+    for(size_t c = 0; c < converted.size(); c++)
+        if(!IsInlineConverted(converted[c].type))
+            delete converted[c].object;
+
+    converted.clear();
+}
+
+bool Node::ConvertInt(const std::string &Source, int32_t &Value) const
+{
+    const void *type = &ConvertedType<int32_t>::id;
+
+    ConvertedProperty *convertedProperty = FindConverted(&Source, type);
+    if(convertedProperty){
+        Value = convertedProperty->intValue;
+        return true;
+    }
+
+    if(!Utils::FromString(Source, Value))
+        return false;
+
+    AddConverted(&Source, type).intValue = Value;
+    return true;
+}
+
+bool Node::ConvertFloat(const std::string &Source, float &Value) const
+{
+    const void *type = &ConvertedType<float>::id;
+
+    ConvertedProperty *convertedProperty = FindConverted(&Source, type);
+    if(convertedProperty){
+        Value = convertedProperty->floatValue;
+        return true;
+    }
+
+    if(!Utils::FromString(Source, Value))
+        return false;
+
+    AddConverted(&Source, type).floatValue = Value;
+    return true;
+}
+
+PropertyFormatException Node::CreateFormatException(const std::string &PropertyName, const std::string &Value, const std::string &TypeName) const
+{
+    return PropertyFormatException("Property " + PropertyName + " of node " + name + " is not " + TypeName + ": " + Value);
+}
+
+int32_t Node::GetInt(const std::string &PropertyName) const throw (XmlException)
+{
+    const std::string &prop = GetProperty(PropertyName);
+
+    int32_t value;
+    if(!ConvertInt(prop, value))
+        throw CreateFormatException(PropertyName, prop, "an int");
+
+    return value;
+}
+
+int32_t Node::GetInt(Atom PropertyName) const throw (XmlException)
+{
+    const std::string &prop = GetProperty(PropertyName);
+
+    int32_t value;
+    if(!ConvertInt(prop, value))
+        throw CreateFormatException(GetAtomName(PropertyName), prop, "an int");
+
+    return value;
+}
+
+float Node::GetFloat(const std::string &PropertyName) const throw (XmlException)
+{
+    const std::string &prop = GetProperty(PropertyName);
+
+    float value;
+    if(!ConvertFloat(prop, value))
+        throw CreateFormatException(PropertyName, prop, "a float");
+
+    return value;
+}
+
+float Node::GetFloat(Atom PropertyName) const throw (XmlException)
+{
+    const std::string &prop = GetProperty(PropertyName);
+
+    float value;
+    if(!ConvertFloat(prop, value))
+        throw CreateFormatException(GetAtomName(PropertyName), prop, "a float");
+
+    return value;
+}
+
+template<class TVar, class TName, class TGetter>
+static void extract_values(const NodesGroup *Group, const TName &PropertyName, std::vector<TVar> &Values, TGetter Getter)
+{
+    Values.resize(Group ? Group->size() : 0);
+    for(size_t n = 0; n < Values.size(); n++)
+        Values[n] = Getter(*(*Group)[n], PropertyName);
+}
+
+void Node::GetInts(const std::string &NodesName, const std::string &PropertyName, std::vector<int32_t> &Values) const throw (XmlException)
+{
+    Materialize();
+
+    NodesContainer::const_iterator ci = nodes.find(NodesName);
+    extract_values(ci != nodes.end() ? &ci->second : NULL, PropertyName, Values,
+                   [](const Node &N, const std::string &P){return N.GetInt(P);});
+}
+
+void Node::GetInts(Atom NodesName, Atom PropertyName, std::vector<int32_t> &Values) const throw (XmlException)
+{
+    extract_values(FindGroup(NodesName), PropertyName, Values, [](const Node &N, Atom P){return N.GetInt(P);});
+}
+
+void Node::GetFloats(const std::string &NodesName, const std::string &PropertyName, std::vector<float> &Values) const throw (XmlException)
+{
+    Materialize();
+
+    NodesContainer::const_iterator ci = nodes.find(NodesName);
+    extract_values(ci != nodes.end() ? &ci->second : NULL, PropertyName, Values,
+                   [](const Node &N, const std::string &P){return N.GetFloat(P);});
+}
+
+void Node::GetFloats(Atom NodesName, Atom PropertyName, std::vector<float> &Values) const throw (XmlException)
+{
+    extract_values(FindGroup(NodesName), PropertyName, Values, [](const Node &N, Atom P){return N.GetFloat(P);});
+}
+
 bool Node::FindNode(const std::string &Name, ConstNodesSet &ConstNodes, bool Recursive) const
 {        
     ConstNodesSet findedNodes;
     NodeFinder<ConstNodesSet> finder(&Name, &findedNodes, Recursive);
-    for_each_node(nodes.begin(), nodes.end(), finder);
+    finder.Run(*this);
 
     ConstNodes.insert(ConstNodes.end(), findedNodes.begin(), findedNodes.end());
     return findedNodes.size() != 0;    
@@ -235,7 +696,7 @@ bool Node::FindNode(const std::string &Name, NodesSet &Nodes, bool Recursive)
 {    
     NodesSet findedNodes;
     NodeFinder<NodesSet> finder(&Name, &findedNodes, Recursive);
-    for_each_node(nodes.begin(), nodes.end(), finder);
+    finder.Run(*this);
 
     Nodes.insert(Nodes.end(), findedNodes.begin(), findedNodes.end());
     return findedNodes.size() != 0;
@@ -245,7 +706,7 @@ bool Node::FindNode(const std::string &PropName, const std::string &PropVal, Con
 {
     ConstNodesSet findedNodes;
     NodeFinder<ConstNodesSet> finder(&PropName, &PropVal, &findedNodes, Recursive);
-    for_each_node(nodes.begin(), nodes.end(), finder);
+    finder.Run(*this);
 
     ConstNodes.insert(ConstNodes.end(), findedNodes.begin(), findedNodes.end());
     return findedNodes.size() != 0;   
@@ -255,7 +716,47 @@ bool Node::FindNode(const std::string &PropName, const std::string &PropVal, Nod
 {
     NodesSet findedNodes;
     NodeFinder<NodesSet> finder(&PropName, &PropVal, &findedNodes, Recursive);
-    for_each_node(nodes.begin(), nodes.end(), finder);
+    finder.Run(*this);
+
+    Nodes.insert(Nodes.end(), findedNodes.begin(), findedNodes.end());
+    return findedNodes.size() != 0;
+}
+
+bool Node::FindNode(Atom Name, ConstNodesSet &ConstNodes, bool Recursive) const
+{        
+    ConstNodesSet findedNodes;
+    NodeFinder<ConstNodesSet> finder(Name, &findedNodes, Recursive);
+    finder.Run(*this);
+
+    ConstNodes.insert(ConstNodes.end(), findedNodes.begin(), findedNodes.end());
+    return findedNodes.size() != 0;    
+}
+
+bool Node::FindNode(Atom Name, NodesSet &Nodes, bool Recursive)
+{    
+    NodesSet findedNodes;
+    NodeFinder<NodesSet> finder(Name, &findedNodes, Recursive);
+    finder.Run(*this);
+
+    Nodes.insert(Nodes.end(), findedNodes.begin(), findedNodes.end());
+    return findedNodes.size() != 0;
+}
+
+bool Node::FindNode(Atom PropName, const std::string &PropVal, ConstNodesSet &ConstNodes, bool Recursive) const
+{
+    ConstNodesSet findedNodes;
+    NodeFinder<ConstNodesSet> finder(PropName, &PropVal, &findedNodes, Recursive);
+    finder.Run(*this);
+
+    ConstNodes.insert(ConstNodes.end(), findedNodes.begin(), findedNodes.end());
+    return findedNodes.size() != 0;   
+}
+
+bool Node::FindNode(Atom PropName, const std::string &PropVal, NodesSet &Nodes, bool Recursive)
+{
+    NodesSet findedNodes;
+    NodeFinder<NodesSet> finder(PropName, &PropVal, &findedNodes, Recursive);
+    finder.Run(*this);
 
     Nodes.insert(Nodes.end(), findedNodes.begin(), findedNodes.end());
     return findedNodes.size() != 0;
@@ -263,6 +764,8 @@ bool Node::FindNode(const std::string &PropName, const std::string &PropVal, Nod
 
 NodesNamesDataStorage Node::GetNodesNames() const
 {
+    Materialize();
+
     NodesNamesDataStorage nodeNames;
 
     NodesContainer::const_iterator ci;
@@ -274,6 +777,8 @@ NodesNamesDataStorage Node::GetNodesNames() const
 
 size_t Node::GetNodesCount(const std::string &Name) const
 {
+    Materialize();
+
     NodesContainer::const_iterator ci = nodes.find(Name);
     if(ci == nodes.end())
         return 0;
@@ -281,6 +786,20 @@ size_t Node::GetNodesCount(const std::string &Name) const
     return ci->second.size();
 }
 
+size_t Node::GetNodesCount(Atom Name) const
+{
+    const NodesGroup *set = FindGroup(Name);
+    return set ? set->size() : 0;
+}
+
+void Node::SetName(const std::string &Name)
+{
+    name = Name;
+    nameAtom = document ? document->names.Intern(Name) : INVALID_ATOM;
+
+    Touch();
+}
+
 std::vector<std::string> Node::GetPropertiesNames() const
 {
     std::vector<std::string> propsNames;
@@ -294,415 +813,367 @@ std::vector<std::string> Node::GetPropertiesNames() const
 
 void Node::AddProperty(const std::string &Name, const std::string &Value) throw (XmlException)
 {
-    PropertiesStorage::const_iterator ci = properties.find(Name);
-    if(ci != properties.end())
-        throw PropertyExistException(std::string("Property ") + Name + " already exist in node " + name);
-
-    properties.insert(std::make_pair(Name, Value));   
+    InsertProperty(Name, Value);
 }
 
 void Node::RemoveProperty(const std::string &Name)
 {
-    properties.erase(Name);
+    PropertiesStorage::iterator it = properties.find(Name);
+    if(it == properties.end())
+        return;
+
+    for(size_t p = 0; p < propertiesAtoms.size(); p++)
+        if(propertiesAtoms[p].second == &it->second){
+            propertiesAtoms.erase(propertiesAtoms.begin() + p);
+            break;
+        }
+
+    ForgetConverted(&it->second);
+    properties.erase(it);
+
+    Touch();
 }
 
 void Node::AddNode(const Node &NewNode)
 {    
-    nodes[NewNode.GetName()].push_back(new Node(NewNode));
+    Materialize();
+
+    AttachNode(NewNode.CreateCopy(arena, document));
 }
 
-void Node::RemoveNode(const std::string &Name, int32_t Ind) throw (XmlException)
+void Node::AddNode(Node &&NewNode)
 {
-    NodesContainer::iterator it = nodes.find(Name);
-    if(it == nodes.end())
+    //heap nodes can be owned by nodes from an arena, nodes of another arena are copied
+    if((NewNode.arena && NewNode.arena != arena) || !NewNode.IsMovableTo(document)){
+        AddNode(NewNode);
         return;
-
-    NodesSet &set = it->second;
-    NodesSet::iterator sit = set.begin();
-
-    if(Ind == -1){
-        
-        for(; sit != set.end(); delete *sit++);
-
-        nodes.erase(it);
-    }else{
-        if(Ind < 0 || Ind > (int32_t)set.size())
-            throw XmlException("Invalid deleting index");
-
-        std::advance(sit, Ind);
-        delete *sit;
-        
-        set.erase(sit);
-        if(!set.size())
-            nodes.erase(it);
     }
-    
-}
-
-void Node::WriteToFile(FILE * File, int32_t &Level) const throw (XmlException)
-{
-    if(!nodes.size() && value == "")
-        write_to_file("<" + name + get_propertis_string(properties) + "/>", File, Level);
-    else{
-        write_to_file("<" + name + get_propertis_string(properties) + ">", File, Level);
 
-        Level++;
+    Materialize();
 
-        write_to_file(value, File, Level);
+    Node *newNode = Allocate(NewNode.arena, document);
 
-        for_each_node(nodes.begin(), nodes.begin(), NodeFileWriter(File, Level));        
-
-        Level--;
-
-        write_to_file("</" + name + ">", File, Level);
+    try{
+        newNode->TakeContent(NewNode);
+    }catch(const Exception &){
+        Free(newNode);
+        throw;
     }
 
+    AttachNode(newNode);
 }
 
-std::string Node::ToString(int32_t &Level) const
+void Node::AddNode(const SharedNode &NewNode)
 {
-    if(!nodes.size() && value == "")
-        return to_string("<" + name + get_propertis_string(properties) + "/>", Level);
-    else{
-        std::string outData = to_string("<" + name + get_propertis_string(properties) + ">", Level);
+    Materialize();
 
-        Level++;
-        
-        outData += to_string(value, Level); 
+    AttachShared(NewNode);
+}
 
-        for_each_node(nodes.begin(), nodes.end(), NodeStringAppender(&outData, Level));
+Node &Node::CreateNode(const std::string &Name)
+{
+    Materialize();
 
-        Level--;
+    Node *newNode = Allocate(arena, document);
+    newNode->SetName(Name);
 
-        outData += to_string("</" + name + ">", Level);
+    AttachNode(newNode);
 
-        return outData;
-    }
-    
+    return *newNode;
 }
 
-void Node::ClearNodes()
+SharedNode Node::Share(const Node &Source)
 {
-    for_each_node(nodes.begin(), nodes.end(), [](Node * ProcessNode) { delete ProcessNode;} );
-    nodes.clear();
+    return std::make_shared<Node>(Source);
 }
 
-NodeIterator Node::begin()
+SharedNode Node::Share(Node &&Source)
 {
-    return NodeIterator(this, (nodes.size()) ? nodes.begin()->first : "", 0);
+    return std::make_shared<Node>(std::move(Source));
 }
 
-NodeIterator Node::end()
+void Node::EraseChildren(const NodesGroup &Group)
 {
-    return NodeIterator(this, "LastFor" + Utils::ToString(this), 0);
+    NodesGroup erasing(Group);
+    std::sort(erasing.begin(), erasing.end());
+
+    children.erase(std::remove_if(children.begin(), children.end(), 
+                                  [&erasing](Node *Child){return std::binary_search(erasing.begin(), erasing.end(), Child);}), 
+                   children.end());
 }
 
-ConstNodeIterator Node::begin() const
+void Node::EraseGroup(NodesContainer::iterator Group)
 {
-    return ConstNodeIterator(this, (nodes.size()) ? nodes.begin()->first : "", 0);
+    for(size_t g = 0; g < nodesAtoms.size(); g++)
+        if(nodesAtoms[g].second == &Group->second){
+            nodesAtoms.erase(nodesAtoms.begin() + g);
+            break;
+        }
+
+    nodes.erase(Group);
 }
 
-ConstNodeIterator Node::end() const
+void Node::RemoveNode(const std::string &Name, int32_t Ind) throw (XmlException)
 {
-    return ConstNodeIterator(this, "LastFor" + Utils::ToString(this), 0);
-}
+    Materialize();
+
+    NodesContainer::iterator it = nodes.find(Name);
+    if(it == nodes.end())
+        return;
 
-XmlData::XmlData() : 
-    stringState(false), 
-    shieldChar(false), 
-    isSingleNode(false), 
-    nodeClosed(false),
-    varAsEmptyStr(false),
-    lastNode(NULL),
-    state(STATE_IDLE), 
-    structState(STRUCT_STATE_NODE_DEFINITION), 
-    headerState(HEADER_STATE_NOT_SET)  {}
+    NodesGroup &set = it->second;
+    NodesGroup::iterator sit = set.begin();
 
-void XmlData::ProcessNodeDefinitionStart() throw (XmlException)
-{
-    if(state != STATE_IDLE)
-        throw cursor.CreateException("Invalid syntax");
+    if(Ind == -1){
+        
+        EraseChildren(set);
 
-    if(text != ""){
-        if(!lastNode)
-            throw cursor.CreateException("Invalid syntax");
+        for(; sit != set.end(); Free(*sit++));
 
-        lastNode->SetValue(lastNode->GetValue() + text);
-        text = "";
-    }
+        EraseGroup(it);
+    }else{
+        if(Ind < 0 || Ind >= (int32_t)set.size())
+            throw XmlException("Invalid deleting index");
 
-    lastNode = (processingNodes.size() == 1) ? processingNodes[0] : new Node();
+        std::advance(sit, Ind);
 
-    state = STATE_NODE_NAME;
-    structState = STRUCT_STATE_NODE_DEFINITION;
+        children.erase(std::find(children.begin(), children.end(), *sit));
+        Free(*sit);
+        
+        set.erase(sit);
+        if(!set.size())
+            EraseGroup(it);
+    }
+
+    Touch();
 }
 
-void XmlData::Cursor::ProcessChar(char Char)
+void Node::ClearNodes()
 {
-    if(Char == '\n'){
-        line++;
-        coll = 1;
-    }else
-        coll++;
+    //text of the node stays
+    Materialize();
+
+    std::for_each(children.begin(), children.end(), Free);
+    nodes.clear();
+    nodesAtoms.clear();
+    children.clear();
+
+    Touch();
 }
 
-XmlSyntaxException XmlData::Cursor::CreateException(const std::string &Message)
+Node &Node::GetChild(size_t Index) throw (XmlException)
 {
-    std::stringstream sstrm;
-    sstrm << Message << ", Line " << line << " Coll " << coll;
-    return XmlSyntaxException(sstrm.str());
+    return const_cast<Node&>(static_cast<const Node*>(this)->GetChild(Index));
 }
 
-void XmlData::ProcessNodeDefinitionEnd() throw (XmlException)
+const Node &Node::GetChild(size_t Index) const throw (XmlException)
 {
-    const std::string &nodeName = lastNode->GetName();
-
-    if(nodeName == "")
-        throw cursor.CreateException("Empty node name");
-
-    if(varName != ""){
-        lastNode->AddProperty(varName, varData);
-        varName = varData ="";
-    }             
+    Materialize();
 
-    if(headerState != HEADER_STATE_NOT_SET){
-        if(nodeName != "xml")
-            throw cursor.CreateException("Invalid header name");
+    if(Index >= children.size())
+        throw NodeNotFoundException("Invalid child index " + Utils::ToString(Index) + " in node " + name);
 
-        if(headerState != HEADER_STATE_END)
-            throw cursor.CreateException("Invalid header syntax");
-
-        std::vector<std::string> propsNames = lastNode->GetPropertiesNames();
-
-        std::vector<std::string>::const_iterator ci;
-        for(ci = propsNames.begin(); ci != propsNames.end(); ++ci){
-            const std::string &name = *ci;
-            const std::string &val = lastNode->GetProperty(name);
-            header.insert(std::make_pair(name, val));
-        }
+    return *children[Index];
+}
 
-        delete lastNode;
+NodeIterator Node::begin()
+{
+    Materialize();
+    return NodeIterator(children.data());
+}
 
-        headerState = HEADER_STATE_NOT_SET;
-    }else{
+NodeIterator Node::end()
+{
+    Materialize();
+    return NodeIterator(children.data() + children.size());
+}
 
-        if(!isSingleNode)
-            if(nodeClosed){                        
-                if(processingNodes.size() == 1 || processingNodes.back()->GetName() != lastNode->GetName())
-                    throw cursor.CreateException("Invalid closing node syntax");
-        
-                delete lastNode;
+ConstNodeIterator Node::begin() const
+{
+    Materialize();
+    return ConstNodeIterator(children.data());
+}
 
-                processingNodes.pop_back();                
-                lastNode = processingNodes.back();
-            }else{                
-                if(processingNodes.size() > 1)
-                    processingNodes.back()->nodes[nodeName].push_back(lastNode);
+ConstNodeIterator Node::end() const
+{
+    Materialize();
+    return ConstNodeIterator(children.data() + children.size());
+}
 
-                processingNodes.push_back(lastNode);
-            }
-        else{
-            if(processingNodes.back() == lastNode)
-                throw cursor.CreateException("Invalid single node");
 
-            processingNodes.back()->nodes[nodeName].push_back(lastNode);
-        }
-    }
+DocumentBuilder::DocumentBuilder(Node *Root, HeaderData *Header, Utils::Arena *NodesArena, DocumentContext *Document) :
+    root(Root),
+    header(Header),
+    arena(NodesArena),
+    document(Document)
+{}
 
-    nodeClosed = isSingleNode = varAsEmptyStr = false;
-    structState = STRUCT_STATE_NODE_DATA;
-    state = STATE_IDLE;
+void DocumentBuilder::OnHeader(const HeaderData &Header)
+{
+    header->insert(Header.begin(), Header.end());
 }
 
-void XmlData::ProcessSlash() throw (XmlException)
+void DocumentBuilder::OnNodeStart(const std::string &Name)
 {
-    if(structState == STRUCT_STATE_NODE_DATA){
-        text += '/';        
+    //first node of the document is the root itself
+    if(!processingNodes.size()){
+        root->SetName(Name);
+        processingNodes.push_back(root);
         return;
     }
 
-    if(state == STATE_IDLE)
-        throw cursor.CreateException("Invalid slash syntax");
-
-    isSingleNode = lastNode->GetName() != "";
+    Node *newNode = Node::Allocate(arena, document);
+    newNode->SetName(Name);
 
-    nodeClosed = true;
+    processingNodes.back()->AttachNode(newNode);
+    processingNodes.push_back(newNode);
 }
 
-void XmlData::ProcessSpace() throw (XmlException)
+void DocumentBuilder::OnProperty(const std::string &Name, const std::string &Value)
 {
-    if(structState == STRUCT_STATE_NODE_DATA){
-       text += ' ';
-       return;
-    }
-        
-    if(lastNode->GetName() == "")
-        state = STATE_NODE_NAME;
-    else if(varData != "" || varAsEmptyStr){
-        lastNode->AddProperty(varName, varData);
-        varName = varData ="";
-        state = STATE_NODE_ATTR_NAME;
-        varAsEmptyStr = false;
-    }else if(state != STATE_IDLE && state != STATE_NODE_ATTR_VAL)
-        state = STATE_NODE_ATTR_NAME;
+    processingNodes.back()->InsertProperty(Name, Value);
 }
 
-void XmlData::ProcessQuestionChar() throw (XmlException)
+void DocumentBuilder::OnText(const std::string &Text)
 {
-    if(structState == STRUCT_STATE_NODE_DATA){
-        text += '?';
-        return;
-    }
-
-    if(state == STATE_IDLE)
-        throw cursor.CreateException("Invalid header syntax");
-        
-    if(headerState == HEADER_STATE_NOT_SET){
-        if(lastNode != processingNodes[0])
-            throw cursor.CreateException("Invalid header syntax");
-
-        if(lastNode->GetName() != "")
-            throw cursor.CreateException("Invalid header syntax");
-
-        lastNode = new Node();
-    }        
-            
-    headerState = (headerState == HEADER_STATE_BEGIN) ? HEADER_STATE_END : HEADER_STATE_BEGIN;
+    processingNodes.back()->value.append(Text);
 }
 
-void XmlData::ProcessEqualChar() throw (XmlException)
+void DocumentBuilder::OnNodeEnd(const std::string &Name)
 {
-    if(structState == STRUCT_STATE_NODE_DATA){        
-        text += '=';
-        return;
-    }
-        
-    if(state != STATE_NODE_ATTR_NAME)
-        throw cursor.CreateException("Invalid property syntax");
+    processingNodes.pop_back();
+}
 
-    state = STATE_NODE_ATTR_VAL;
+XmlData::XmlData(StorageMode Mode) : storageMode(Mode), cacheMode(CACHE_MODE_BINARY)
+{
+    rootNode.document = &document;
+    document.arenaStorage = storageMode == STORAGE_MODE_ARENA;
+    document.index.SetRoot(&rootNode);
 }
 
-void XmlData::ProcessChar(char Char) throw (XmlException)
+void XmlData::ClearStorage()
 {
-    cursor.ProcessChar(Char);
+    //root node itself lives on the heap, only its descendants can be in the arena
+    rootNode.lazyElement = INVALID_ELEMENT;
+    rootNode.ClearNodes();
+    rootNode.ClearProperties();
+    rootNode.name.clear();
+    rootNode.nameAtom = INVALID_ATOM;
+    rootNode.value.clear();
 
-    if(Char == '"'){
-        stringState = !stringState;
+    arena.Clear();
 
-        if(!stringState && state == STATE_NODE_ATTR_VAL && varData == "")
-            varAsEmptyStr = true;
+    for(size_t a = 0; a < chunksArenas.size(); a++)
+        delete chunksArenas[a];
 
-        return;
-    }
+    chunksArenas.clear();
 
-    if(Char == '\\'){
-        if(!stringState)
-            throw cursor.CreateException("Slash out of the string");
+    document.lazy = NULL;
+    lazyContent.reset();
+}
 
-        shieldChar = !shieldChar;
+void XmlData::LoadFromFile(const std::string &FilePath, LoadMode Mode) throw (XmlException)
+{
+    Clear();
+
+    //lazy document keeps its source, cache would need the whole tree
+    if(Mode == LOAD_MODE_LAZY){
+        lazyContent.reset(new LazyContent());
+        lazyContent->OpenFile(FilePath);
+        LoadLazy();
         return;
     }
 
-    if(stringState || shieldChar){
-        if(state == STATE_IDLE)
-            text += Char;
-        else if(state == STATE_NODE_ATTR_VAL)
-            varData += Char;
-        else 
-            throw cursor.CreateException("Invalid literal");
-    
-        if(shieldChar)
-            shieldChar = false;
+    //cache is used only while it matches size and write time of the source
+    CacheStamp stamp;
+    bool cached = cacheMode == CACHE_MODE_BINARY && GetCacheStamp(FilePath, stamp);
+    if(cached && LoadFromCache(GetCachePath(FilePath), stamp))
         return;
-    }
 
-    if(Char == '<'){
-        ProcessNodeDefinitionStart();
-    }else if(Char == '>'){
-       ProcessNodeDefinitionEnd();
-    }else if(Char == '/'){
-        ProcessSlash();
-    }else if(Char == ' '){
-        ProcessSpace();
-    }else if(Char == '?'){
-        ProcessQuestionChar();
-    }else if(Char == '='){
-        ProcessEqualChar();
-    }else if(!isspace(Char)){
-        if(state == STATE_NODE_NAME)
-            lastNode->SetName(lastNode->GetName() + Char);
-        else if(state == STATE_NODE_ATTR_NAME)
-            varName += Char;
-        else if(state == STATE_NODE_ATTR_VAL)
-            varData += Char;
-        else
-            text += Char;
+    if(Mode == LOAD_MODE_PARALLEL){
+        Utils::MappedFile file(FilePath);
+        LoadParallel(file.begin(), file.end());
+    }else{
+        DocumentBuilder builder(&rootNode, &header, GetNodesArena(), &document);
+        XmlReader reader(&builder);
+        reader.ReadFile(FilePath, Mode);
     }
+
+    if(cached)
+        SaveToCache(GetCachePath(FilePath), stamp);
 }
 
-void XmlData::Cleanup()
+void XmlData::LoadFromString(const std::string &DataString, LoadMode Mode) throw (XmlException)
 {
-    state = STATE_IDLE;
-    structState = STRUCT_STATE_NODE_DEFINITION;
-
-    stringState = shieldChar = isSingleNode = nodeClosed = varAsEmptyStr = false;
-
-    text = varName = varData = "";
-
-    processingNodes.clear();
+    Clear();
 
-    lastNode = NULL;
+    if(Mode == LOAD_MODE_LAZY){
+        lazyContent.reset(new LazyContent());
+        lazyContent->OpenString(DataString);
+        LoadLazy();
+        return;
+    }
 
-    cursor.Clear();
+    DocumentBuilder builder(&rootNode, &header, GetNodesArena(), &document);
+    XmlReader reader(&builder);
+    reader.ReadString(DataString);
 }
 
-void XmlData::LoadFromFile(const std::string &FilePath) throw (XmlException)
+void XmlData::LoadLazy() throw (XmlException)
 {
-    Utils::FileGuard file(FilePath, "r");
+    document.lazy = lazyContent.get();
 
-	Utils::AutoEvent evnt(std::bind(&XmlData::Cleanup, this));
-
-    const size_t blockSize = 1024;
-    char block[blockSize];
+    try{
+        lazyContent->Load(rootNode, header, GetNodesArena(), &document);
+        return;
+    }catch(const Exception &){
+        //errors get exact positions only from the sequential parse
+    }
 
-    rootNode.ClearNodes();
-    processingNodes.push_back(&rootNode);
+    std::unique_ptr<LazyContent> content(std::move(lazyContent));
+    Clear();
 
-    while(!feof(file.get())){
-        size_t nRead = fread(block, 1, blockSize, file.get());
-        for(size_t i = 0; i < nRead; i++)
-            ProcessChar(block[i]);
-    }
+    DocumentBuilder builder(&rootNode, &header, GetNodesArena(), &document);
+    XmlReader reader(&builder);
+    reader.Parse(content->GetBegin(), content->GetEnd());
 }
 
-void XmlData::LoadFromString(const std::string &DataString) throw (XmlException)
+Atom XmlData::GetAtom(const std::string &Name) const
 {
-	Utils::AutoEvent evnt(std::bind(&XmlData::Cleanup, this));
+    //names of a lazy document are known only after its nodes are parsed, so the atom is reserved now
+    if(document.lazy)
+        return const_cast<NameTable&>(document.names).Intern(Name);
 
-    rootNode.ClearNodes();
-    processingNodes.push_back(&rootNode);
+    return document.names.Find(Name);
+}
 
-    std::string::const_iterator ci;
-    for(ci = DataString.begin(); ci != DataString.end(); ++ci)
-        ProcessChar(*ci);
+void XmlData::BuildIndex()
+{
+    document.index.Enable(true);
+    document.index.Prepare();
 }
 
 std::string XmlData::ToString() const
 {
-    std::string outString = to_string(header_to_string(header), 0);
+    XmlWriter writer;
+    writer.WriteHeader(header);
 
-    int32_t level = 0;
-    return outString + rootNode.ToString(level);
+    if(rootNode.name.size())
+        writer.WriteNode(rootNode);
+
+    return writer.TakeData();
 }
 
 void XmlData::SaveToFile(const std::string &FilePath) const throw (XmlException)
 {
     Utils::FileGuard file(FilePath, "w");
 
-    write_to_file(header_to_string(header), file.get(), 0);
+    XmlWriter writer(file.get());
+    writer.WriteHeader(header);
 
-    int32_t level = 0;
-    rootNode.WriteToFile(file.get(), level);
-}
+    if(rootNode.name.size())
+        writer.WriteNode(rootNode);
+
+    writer.Flush();
 }
+}
\ No newline at end of file
@@ -0,0 +1,313 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <Xml.h>
+#include <Utils/FileGuard.h>
+#include <Utils/MappedFile.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+#include <cstring>
+#include <cstdio>
+
+namespace XML
+{
+
+//binary image of a document in host byte order, everything is addressed by indices:
+//header, strings, nodes in document order, node properties followed by header properties, chars.
+//Byte order marker is written as a number, cache of a host with another order is taken as stale
+const char CACHE_MAGIC[4] = {'X', 'M', 'L', 'B'};
+const uint32_t CACHE_VERSION = 2;
+const uint32_t CACHE_BYTE_ORDER = 0x01020304;
+const uint32_t CACHE_NO_PARENT = 0xFFFFFFFF;
+
+struct CacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t sourceSize;
+    uint64_t sourceTime;
+    uint32_t fileSize;
+    uint32_t stringsCount;
+    uint32_t nodesCount;
+    uint32_t propertiesCount;
+    uint32_t headerCount;
+    uint32_t charsSize;
+};
+
+struct CacheString
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct CacheNode
+{
+    uint32_t parent;
+    uint32_t name;
+    uint32_t value;
+    uint32_t firstProperty;
+    uint32_t propertiesCount;
+};
+
+struct CacheProperty
+{
+    uint32_t name;
+    uint32_t value;
+};
+
+static_assert(sizeof(CacheHeader) == 56, "Unexpected cache header layout");
+static_assert(sizeof(CacheNode) == 20, "Unexpected cache node layout");
+
+class CacheStrings
+{
+private:
+    std::unordered_map<std::string, uint32_t> ids;
+public:
+    std::vector<CacheString> strings;
+    std::string chars;
+    uint32_t Add(const std::string &String)
+    {
+        std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> res = ids.insert(std::make_pair(String, (uint32_t)strings.size()));
+        if(res.second){
+            CacheString str = {(uint32_t)chars.size(), (uint32_t)String.size()};
+            strings.push_back(str);
+            chars += String;
+        }
+
+        return res.first->second;
+    }
+};
+
+template<class TVar>
+static void append_array(std::vector<char> &Image, const std::vector<TVar> &Array)
+{
+    if(Array.size())
+        Image.insert(Image.end(), reinterpret_cast<const char*>(Array.data()), reinterpret_cast<const char*>(Array.data() + Array.size()));
+}
+
+bool XmlData::GetCacheStamp(const std::string &FilePath, CacheStamp &Stamp)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if(!GetFileAttributesExA(FilePath.c_str(), GetFileExInfoStandard, &data))
+        return false;
+
+    Stamp.size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    Stamp.time = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat data;
+    if(stat(FilePath.c_str(), &data))
+        return false;
+
+    Stamp.size = (uint64_t)data.st_size;
+    Stamp.time = (uint64_t)data.st_mtim.tv_sec * 1000000000 + data.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+bool XmlData::LoadFromCache(const std::string &CachePath, const CacheStamp &Stamp)
+{
+    //missing, stale or broken cache just means parsing the source
+    try{
+        Utils::MappedFile file(CachePath);
+        if(ReadCache(file.GetData(), file.GetSize(), Stamp))
+            return true;
+    }catch(const Exception &){
+    }
+
+    Clear();
+    return false;
+}
+
+bool XmlData::ReadCache(const char *Data, size_t Size, const CacheStamp &Stamp) throw (XmlException)
+{
+    CacheHeader cacheHeader;
+    if(Size < sizeof(cacheHeader))
+        return false;
+
+    memcpy(&cacheHeader, Data, sizeof(cacheHeader));
+
+    if(memcmp(cacheHeader.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) || cacheHeader.version != CACHE_VERSION)
+        return false;
+
+    if(cacheHeader.byteOrder != CACHE_BYTE_ORDER)
+        return false;
+
+    if(cacheHeader.sourceSize != Stamp.size || cacheHeader.sourceTime != Stamp.time || cacheHeader.fileSize != Size)
+        return false;
+
+    uint64_t expectedSize = sizeof(CacheHeader) +
+                            (uint64_t)cacheHeader.stringsCount * sizeof(CacheString) +
+                            (uint64_t)cacheHeader.nodesCount * sizeof(CacheNode) +
+                            ((uint64_t)cacheHeader.propertiesCount + cacheHeader.headerCount) * sizeof(CacheProperty) +
+                            cacheHeader.charsSize;
+
+    if(expectedSize != Size || !cacheHeader.nodesCount)
+        return false;
+
+    const CacheString *strings = reinterpret_cast<const CacheString*>(Data + sizeof(CacheHeader));
+    const CacheNode *cacheNodes = reinterpret_cast<const CacheNode*>(strings + cacheHeader.stringsCount);
+    const CacheProperty *cacheProperties = reinterpret_cast<const CacheProperty*>(cacheNodes + cacheHeader.nodesCount);
+    const char *chars = reinterpret_cast<const char*>(cacheProperties + cacheHeader.propertiesCount + cacheHeader.headerCount);
+
+    for(uint32_t s = 0; s < cacheHeader.stringsCount; s++)
+        if((uint64_t)strings[s].offset + strings[s].length > cacheHeader.charsSize)
+            return false;
+
+    //strings used as names are interned once
+    std::vector<Atom> atoms(cacheHeader.stringsCount, INVALID_ATOM);
+    std::string propName, propValue;
+
+    std::vector<Node*> createdNodes(cacheHeader.nodesCount, NULL);
+    for(uint32_t n = 0; n < cacheHeader.nodesCount; n++){
+        const CacheNode &cacheNode = cacheNodes[n];
+
+        if(cacheNode.name >= cacheHeader.stringsCount || cacheNode.value >= cacheHeader.stringsCount)
+            return false;
+
+        if((n == 0) != (cacheNode.parent == CACHE_NO_PARENT) || (n && cacheNode.parent >= n))
+            return false;
+
+        if((uint64_t)cacheNode.firstProperty + cacheNode.propertiesCount > cacheHeader.propertiesCount)
+            return false;
+
+        const CacheString &name = strings[cacheNode.name];
+        const CacheString &value = strings[cacheNode.value];
+
+        //only an empty document has a node without name
+        if(name.length && atoms[cacheNode.name] == INVALID_ATOM)
+            atoms[cacheNode.name] = document.names.Intern(std::string(chars + name.offset, name.length));
+
+        Node *node = n ? Node::Allocate(GetNodesArena(), &document) : &rootNode;
+        node->name.assign(chars + name.offset, name.length);
+        node->nameAtom = atoms[cacheNode.name];
+        node->value.assign(chars + value.offset, value.length);
+
+        if(n)
+            createdNodes[cacheNode.parent]->AttachNode(node);
+
+        createdNodes[n] = node;
+
+        for(uint32_t p = cacheNode.firstProperty; p < cacheNode.firstProperty + cacheNode.propertiesCount; p++){
+            const CacheProperty &cacheProperty = cacheProperties[p];
+            if(cacheProperty.name >= cacheHeader.stringsCount || cacheProperty.value >= cacheHeader.stringsCount)
+                return false;
+
+            const CacheString &propNameString = strings[cacheProperty.name];
+            const CacheString &propValueString = strings[cacheProperty.value];
+
+            propName.assign(chars + propNameString.offset, propNameString.length);
+            propValue.assign(chars + propValueString.offset, propValueString.length);
+
+            if(atoms[cacheProperty.name] == INVALID_ATOM)
+                atoms[cacheProperty.name] = document.names.Intern(propName);
+
+            node->InsertProperty(propName, atoms[cacheProperty.name], propValue);
+        }
+    }
+
+    const CacheProperty *headerProperties = cacheProperties + cacheHeader.propertiesCount;
+    for(uint32_t h = 0; h < cacheHeader.headerCount; h++){
+        if(headerProperties[h].name >= cacheHeader.stringsCount || headerProperties[h].value >= cacheHeader.stringsCount)
+            return false;
+
+        const CacheString &name = strings[headerProperties[h].name];
+        const CacheString &value = strings[headerProperties[h].value];
+
+        header[std::string(chars + name.offset, name.length)] = std::string(chars + value.offset, value.length);
+    }
+
+    return true;
+}
+
+void XmlData::SaveToCache(const std::string &CachePath, const CacheStamp &Stamp) const
+{
+    CacheStrings cacheStrings;
+    std::vector<CacheNode> cacheNodes;
+    std::vector<CacheProperty> cacheProperties;
+
+    //document order, parents always come before their children
+    std::vector<std::pair<const Node*, uint32_t> > stack(1, std::make_pair(&rootNode, CACHE_NO_PARENT));
+    while(stack.size()){
+        const Node *node = stack.back().first;
+        uint32_t parent = stack.back().second;
+        stack.pop_back();
+
+        CacheNode cacheNode;
+        cacheNode.parent = parent;
+        cacheNode.name = cacheStrings.Add(node->name);
+        cacheNode.value = cacheStrings.Add(node->value);
+        cacheNode.firstProperty = (uint32_t)cacheProperties.size();
+        cacheNode.propertiesCount = (uint32_t)node->propertiesAtoms.size();
+
+        for(size_t p = 0; p < node->propertiesAtoms.size(); p++){
+            CacheProperty cacheProperty;
+            cacheProperty.name = cacheStrings.Add(document.names.GetName(node->propertiesAtoms[p].first));
+            cacheProperty.value = cacheStrings.Add(*node->propertiesAtoms[p].second);
+            cacheProperties.push_back(cacheProperty);
+        }
+
+        uint32_t index = (uint32_t)cacheNodes.size();
+        cacheNodes.push_back(cacheNode);
+
+        for(size_t c = node->children.size(); c > 0; c--)
+            stack.push_back(std::make_pair(node->children[c - 1], index));
+    }
+
+    uint32_t propertiesCount = (uint32_t)cacheProperties.size();
+
+    HeaderData::const_iterator ci;
+    for(ci = header.begin(); ci != header.end(); ++ci){
+        CacheProperty cacheProperty;
+        cacheProperty.name = cacheStrings.Add(ci->first);
+        cacheProperty.value = cacheStrings.Add(ci->second);
+        cacheProperties.push_back(cacheProperty);
+    }
+
+    CacheHeader cacheHeader;
+    memcpy(cacheHeader.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    cacheHeader.version = CACHE_VERSION;
+    cacheHeader.byteOrder = CACHE_BYTE_ORDER;
+    cacheHeader.reserved = 0;
+    cacheHeader.sourceSize = Stamp.size;
+    cacheHeader.sourceTime = Stamp.time;
+    cacheHeader.stringsCount = (uint32_t)cacheStrings.strings.size();
+    cacheHeader.nodesCount = (uint32_t)cacheNodes.size();
+    cacheHeader.propertiesCount = propertiesCount;
+    cacheHeader.headerCount = (uint32_t)(cacheProperties.size() - propertiesCount);
+    cacheHeader.charsSize = (uint32_t)cacheStrings.chars.size();
+    cacheHeader.fileSize = (uint32_t)(sizeof(CacheHeader) +
+                                      cacheStrings.strings.size() * sizeof(CacheString) +
+                                      cacheNodes.size() * sizeof(CacheNode) +
+                                      cacheProperties.size() * sizeof(CacheProperty) +
+                                      cacheStrings.chars.size());
+
+    std::vector<char> image(reinterpret_cast<const char*>(&cacheHeader), reinterpret_cast<const char*>(&cacheHeader + 1));
+    image.reserve(cacheHeader.fileSize);
+    append_array(image, cacheStrings.strings);
+    append_array(image, cacheNodes);
+    append_array(image, cacheProperties);
+    image.insert(image.end(), cacheStrings.chars.begin(), cacheStrings.chars.end());
+
+    //cache is optional, read only folders simply stay without it
+    try{
+        Utils::FileGuard file(CachePath, "wb");
+        if(fwrite(image.data(), 1, image.size(), file.get()) == image.size())
+            return;
+    }catch(const Exception &){
+        return;
+    }
+
+    remove(CachePath.c_str());
+}
+
+}
\ No newline at end of file
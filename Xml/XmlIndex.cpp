@@ -0,0 +1,399 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <Xml.h>
+#include <ctype.h>
+#include <algorithm>
+
+namespace XML
+{
+
+static bool is_query_name_char(char Char)
+{
+    return !isspace((unsigned char)Char) && Char != '/' && Char != '[' && Char != ']' &&
+           Char != '*' && Char != '@' && Char != '=' && Char != '\'' && Char != '"';
+}
+
+void NodeIndex::Enable(bool Enabled)
+{
+    enabled = Enabled;
+    valid = false;
+
+    if(enabled)
+        return;
+
+    Records().swap(nodes);
+    std::vector<uint32_t>().swap(ends);
+    std::vector<Records>().swap(byName);
+    std::vector<ValuesRecords>().swap(byProperty);
+}
+
+bool NodeIndex::Prepare()
+{
+    if(!enabled)
+        return false;
+
+    if(!valid)
+        Rebuild();
+
+    return true;
+}
+
+void NodeIndex::Rebuild()
+{
+    nodes.clear();
+    ends.clear();
+    byName.clear();
+    byProperty.clear();
+
+    if(root)
+        Add(root, 0);
+
+    valid = true;
+}
+
+void NodeIndex::Add(Node *IndexingNode, uint32_t Depth)
+{
+    IndexingNode->Materialize();
+
+    Record record;
+    record.order = (uint32_t)nodes.size();
+    record.depth = Depth;
+    record.node = IndexingNode;
+
+    IndexingNode->indexOrder = record.order;
+    nodes.push_back(record);
+    ends.push_back(record.order);
+
+    Atom name = IndexingNode->nameAtom;
+    if(name != INVALID_ATOM){
+        if(name >= byName.size())
+            byName.resize(name + 1);
+
+        byName[name].push_back(record);
+    }
+
+    const Node::PropertiesAtomsIndex &properties = IndexingNode->propertiesAtoms;
+    for(size_t p = 0; p < properties.size(); p++){
+        Atom propName = properties[p].first;
+        if(propName >= byProperty.size())
+            byProperty.resize(propName + 1);
+
+        byProperty[propName][*properties[p].second].push_back(record);
+    }
+
+    const NodesGroup &children = IndexingNode->children;
+    for(size_t c = 0; c < children.size(); c++)
+        Add(children[c], Depth + 1);
+
+    ends[record.order] = (uint32_t)nodes.size();
+}
+
+const NodeIndex::Records *NodeIndex::FindByName(Atom Name) const
+{
+    return (Name < byName.size() && byName[Name].size()) ? &byName[Name] : NULL;
+}
+
+const NodeIndex::Records *NodeIndex::FindByProperty(Atom PropName, const std::string &PropVal) const
+{
+    if(PropName >= byProperty.size())
+        return NULL;
+
+    ValuesRecords::const_iterator ci = byProperty[PropName].find(PropVal);
+    return (ci != byProperty[PropName].end()) ? &ci->second : NULL;
+}
+
+NodeIndex::RecordsRange NodeIndex::GetRange(const Node &Scope, const Records &Source) const
+{
+    uint32_t order = Scope.indexOrder;
+    if(order >= nodes.size() || nodes[order].node != &Scope)
+        return RecordsRange(Source.end(), Source.end());
+
+    //descendants of the scope are exactly the records with order in (order, ends[order])
+    Records::const_iterator first = std::upper_bound(Source.begin(), Source.end(), order,
+                                                     [](uint32_t Order, const Record &R){return Order < R.order;});
+    Records::const_iterator last = std::lower_bound(first, Source.end(), ends[order],
+                                                    [](const Record &R, uint32_t Order){return R.order < Order;});
+    return RecordsRange(first, last);
+}
+
+uint32_t NodeIndex::GetDepth(const Node &Scope) const
+{
+    return (Scope.indexOrder < nodes.size()) ? nodes[Scope.indexOrder].depth : 0;
+}
+
+void NodeIndex::Select(const Node &Scope, const Records &Source, bool Recursive, NodesSet &Nodes) const
+{
+    RecordsRange range = GetRange(Scope, Source);
+    uint32_t depth = GetDepth(Scope) + 1;
+
+    for(Records::const_iterator ci = range.first; ci != range.second; ++ci)
+        if(Recursive || ci->depth == depth)
+            Nodes.push_back(ci->node);
+}
+
+NodeQuery::NodeQuery(const std::string &Path) throw (XmlException) : path(Path), descendantSteps(0)
+{
+    Compile();
+}
+
+XmlQueryException NodeQuery::CreateException(size_t Position) const
+{
+    return XmlQueryException("Invalid query " + path + " at position " + Utils::ToString(Position));
+}
+
+void NodeQuery::Compile() throw (XmlException)
+{
+    size_t pos = 0, len = path.length();
+
+    bool descendant = false;
+    if(path.compare(0, 2, "//") == 0){
+        descendant = true;
+        pos = 2;
+    }
+
+    while(true){
+        Step step;
+        step.descendant = descendant;
+
+        size_t start = pos;
+        if(pos < len && path[pos] == '*')
+            pos++;
+        else{
+            while(pos < len && is_query_name_char(path[pos]))
+                pos++;
+            step.name = path.substr(start, pos - start);
+        }
+
+        while(pos < len && path[pos] == '['){
+            if(++pos >= len || path[pos] != '@')
+                throw CreateException(pos);
+
+            size_t nameStart = ++pos;
+            while(pos < len && is_query_name_char(path[pos]))
+                pos++;
+
+            if(pos == nameStart)
+                throw CreateException(pos);
+
+            Predicate predicate;
+            predicate.name = path.substr(nameStart, pos - nameStart);
+            predicate.hasValue = false;
+
+            if(pos < len && path[pos] == '='){
+                if(++pos >= len || (path[pos] != '\'' && path[pos] != '"'))
+                    throw CreateException(pos);
+
+                size_t valueEnd = path.find(path[pos], pos + 1);
+                if(valueEnd == std::string::npos)
+                    throw CreateException(pos);
+
+                predicate.value = path.substr(pos + 1, valueEnd - pos - 1);
+                predicate.hasValue = true;
+                pos = valueEnd + 1;
+            }
+
+            if(pos >= len || path[pos] != ']')
+                throw CreateException(pos);
+
+            pos++;
+            step.predicates.push_back(predicate);
+        }
+
+        if(pos == start)
+            throw CreateException(pos);
+
+        steps.push_back(step);
+
+        if(pos == len)
+            break;
+
+        if(path[pos] != '/')
+            throw CreateException(pos);
+
+        descendant = (++pos < len && path[pos] == '/');
+        if(descendant)
+            pos++;
+    }
+
+    //walking keeps steps of every node in a bit mask
+    if(steps.size() >= 64)
+        throw XmlQueryException("Too many steps in query " + path);
+
+    for(size_t s = 0; s < steps.size(); s++)
+        if(steps[s].descendant)
+            descendantSteps |= (uint64_t)1 << s;
+}
+
+bool NodeQuery::Match(const Node &TestNode, const Step &TestStep) const
+{
+    if(TestStep.name.size() && TestNode.name != TestStep.name)
+        return false;
+
+    for(size_t p = 0; p < TestStep.predicates.size(); p++){
+        const Predicate &predicate = TestStep.predicates[p];
+
+        Node::PropertiesStorage::const_iterator ci = TestNode.properties.find(predicate.name);
+        if(ci == TestNode.properties.end() || (predicate.hasValue && ci->second != predicate.value))
+            return false;
+    }
+
+    return true;
+}
+
+bool NodeQuery::Match(const Node &TestNode, const Step &TestStep, const BoundStep &Bound) const
+{
+    if(TestStep.name.size() && TestNode.nameAtom != Bound.name)
+        return false;
+
+    for(size_t p = 0; p < TestStep.predicates.size(); p++){
+        const Predicate &predicate = TestStep.predicates[p];
+
+        const std::string *prop = TestNode.FindProperty(Bound.predicates[p]);
+        if(!prop || (predicate.hasValue && *prop != predicate.value))
+            return false;
+    }
+
+    return true;
+}
+
+void NodeQuery::Collect(Node &Context, const Step &TestStep, const BoundStep &Bound, const NodeIndex &Index, NodesSet &Nodes) const
+{
+    Context.Materialize();
+
+    //value predicates are the most selective lists the index has
+    const NodeIndex::Records *records = NULL;
+    for(size_t p = 0; p < TestStep.predicates.size(); p++)
+        if(TestStep.predicates[p].hasValue){
+            records = Index.FindByProperty(Bound.predicates[p], TestStep.predicates[p].value);
+            if(!records)
+                return;
+            break;
+        }
+
+    if(!records && TestStep.descendant)
+        records = TestStep.name.size() ? Index.FindByName(Bound.name) : &Index.GetNodes();
+
+    NodeIndex::RecordsRange range;
+    if(records)
+        range = Index.GetRange(Context, *records);
+
+    //children of one node are usually fewer than the matching records
+    if(!TestStep.descendant && (!records || std::distance(range.first, range.second) >= (ptrdiff_t)Context.children.size())){
+        const NodesGroup *group = TestStep.name.size() ? Context.FindGroup(Bound.name) : &Context.children;
+        if(!group)
+            return;
+
+        for(size_t c = 0; c < group->size(); c++)
+            if(Match(*(*group)[c], TestStep, Bound))
+                Nodes.push_back((*group)[c]);
+
+        return;
+    }
+
+    if(!records)
+        return;
+
+    uint32_t depth = Index.GetDepth(Context) + 1;
+    for(NodeIndex::Records::const_iterator ci = range.first; ci != range.second; ++ci)
+        if((TestStep.descendant || ci->depth == depth) && Match(*ci->node, TestStep, Bound))
+            Nodes.push_back(ci->node);
+}
+
+void NodeQuery::Walk(Node &ProcessNode, uint64_t States, uint64_t Pending, NodesSet &Nodes) const
+{
+    //bit k of States: node is matched by the first k steps, Pending: descendant steps open above
+    uint64_t active = Pending | (States & descendantSteps);
+    uint64_t candidates = active | (States & ~descendantSteps);
+    uint64_t lastState = (uint64_t)1 << steps.size();
+
+    ProcessNode.Materialize();
+
+    for(size_t c = 0; c < ProcessNode.children.size(); c++){
+        Node *child = ProcessNode.children[c];
+
+        uint64_t childStates = 0;
+        for(size_t s = 0; s < steps.size(); s++)
+            if((candidates & ((uint64_t)1 << s)) && Match(*child, steps[s]))
+                childStates |= (uint64_t)1 << (s + 1);
+
+        if(childStates & lastState)
+            Nodes.push_back(child);
+
+        childStates &= ~lastState;
+        if(childStates || active)
+            Walk(*child, childStates, active, Nodes);
+    }
+}
+
+void NodeQuery::Evaluate(const Node &Context, NodesSet &Nodes) const
+{
+    Node &context = const_cast<Node&>(Context);
+
+    DocumentContext *document = context.document;
+    if(!document || !document->index.Prepare()){
+        Walk(context, 1, 0, Nodes);
+        return;
+    }
+
+    //names unknown to the document cant match anything
+    std::vector<BoundStep> bound(steps.size());
+    for(size_t s = 0; s < steps.size(); s++){
+        bound[s].name = steps[s].name.size() ? document->names.Find(steps[s].name) : INVALID_ATOM;
+        if(steps[s].name.size() && bound[s].name == INVALID_ATOM)
+            return;
+
+        for(size_t p = 0; p < steps[s].predicates.size(); p++){
+            Atom propName = document->names.Find(steps[s].predicates[p].name);
+            if(propName == INVALID_ATOM)
+                return;
+
+            bound[s].predicates.push_back(propName);
+        }
+    }
+
+    NodesSet current(1, &context), next;
+    bool nested = false;
+
+    for(size_t s = 0; s < steps.size() && current.size(); s++){
+        next.clear();
+
+        for(size_t c = 0; c < current.size(); c++)
+            Collect(*current[c], steps[s], bound[s], document->index, next);
+
+        //after a descendant step contexts can contain each other
+        nested = nested || steps[s].descendant;
+        if(nested && next.size() > 1){
+            std::sort(next.begin(), next.end(), [](const Node *A, const Node *B){return A->indexOrder < B->indexOrder;});
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+        }
+
+        current.swap(next);
+    }
+
+    Nodes.insert(Nodes.end(), current.begin(), current.end());
+}
+
+bool NodeQuery::Select(const Node &Context, ConstNodesSet &ConstNodes) const
+{
+    NodesSet findedNodes;
+    Evaluate(Context, findedNodes);
+
+    ConstNodes.insert(ConstNodes.end(), findedNodes.begin(), findedNodes.end());
+    return findedNodes.size() != 0;
+}
+
+bool NodeQuery::Select(Node &Context, NodesSet &Nodes) const
+{
+    NodesSet findedNodes;
+    Evaluate(Context, findedNodes);
+
+    Nodes.insert(Nodes.end(), findedNodes.begin(), findedNodes.end());
+    return findedNodes.size() != 0;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <Xml.h>
+#include <Utils/MappedFile.h>
+
+namespace XML
+{
+
+LazyContent::LazyContent() : begin(NULL), end(NULL), nodesArena(NULL)
+{}
+
+LazyContent::~LazyContent()
+{}
+
+void LazyContent::OpenFile(const std::string &FilePath) throw (Exception)
+{
+    file.reset(new Utils::MappedFile(FilePath));
+    begin = file->begin();
+    end = file->end();
+}
+
+void LazyContent::OpenString(const std::string &DataString)
+{
+    buffer = DataString;
+    begin = buffer.data();
+    end = begin + buffer.size();
+}
+
+void LazyContent::Load(Node &Root, HeaderData &Header, Utils::Arena *NodesArena, DocumentContext *Document) throw (XmlException)
+{
+    //root lives outside of the arena, so nodes parsed later take the arena of the document
+    nodesArena = NodesArena;
+
+    XmlReader::ScanElements(begin, end, elements);
+
+    DocumentBuilder builder(&Root, &Header, NodesArena, Document);
+    XmlReader reader(&builder);
+
+    if(!elements.size()){
+        reader.Parse(begin, end);
+        return;
+    }
+
+    //header and root tag are parsed right away
+    const ElementRange &root = elements[0];
+    reader.Parse(begin, begin + root.contentBegin);
+
+    if(reader.GetDepth() != 1 || !reader.IsIdle())
+        throw XmlSyntaxException("Invalid root node " + Root.name);
+
+    Root.lazyElement = 0;
+
+    //text after the root is checked as usual
+    std::string closing = "</" + Root.name + ">";
+    reader.Parse(closing.data(), closing.data() + closing.size());
+    reader.Parse(begin + root.end, end);
+}
+
+void LazyContent::ParseChildren(Node &LazyNode, uint32_t Index) throw (XmlException)
+{
+    const ElementRange &element = elements[Index];
+
+    HeaderData header;
+    DocumentBuilder builder(&LazyNode, &header, nodesArena, LazyNode.document);
+    XmlReader reader(&builder);
+
+    std::string tag = "<" + LazyNode.name + ">";
+    reader.Parse(tag.data(), tag.data() + tag.size());
+
+    //text and tags of the children are parsed, their contents are skipped
+    const char *pos = begin + element.contentBegin;
+    for(uint32_t c = Index + 1; c < element.next; c = elements[c].next){
+        const ElementRange &child = elements[c];
+        size_t childrenCount = LazyNode.children.size();
+
+        reader.Parse(pos, begin + child.contentBegin);
+
+        if(reader.GetDepth() != (child.single ? 1u : 2u) || !reader.IsIdle() || LazyNode.children.size() != childrenCount + 1)
+            throw XmlSyntaxException("Invalid content of node " + LazyNode.name);
+
+        if(!child.single){
+            Node *childNode = LazyNode.children.back();
+            childNode->lazyElement = c;
+
+            tag = "</" + childNode->name + ">";
+            reader.Parse(tag.data(), tag.data() + tag.size());
+        }
+
+        pos = begin + child.end;
+    }
+
+    reader.Parse(pos, begin + element.end);
+
+    if(reader.GetDepth() || !reader.IsIdle())
+        throw XmlSyntaxException("Invalid content of node " + LazyNode.name);
+}
+
+void LazyContent::ParseContent(Node &LazyNode, uint32_t Index) throw (XmlException)
+{
+    const ElementRange &element = elements[Index];
+
+    HeaderData header;
+    DocumentBuilder builder(&LazyNode, &header, nodesArena, LazyNode.document);
+    XmlReader reader(&builder);
+
+    std::string tag = "<" + LazyNode.name + ">";
+    reader.Parse(tag.data(), tag.data() + tag.size());
+    reader.Parse(begin + element.contentBegin, begin + element.end);
+}
+
+void LazyContent::Validate() const throw (XmlException)
+{
+    IXmlHandler handler;
+    XmlReader reader(&handler);
+    reader.Parse(begin, end);
+}
+
+void LazyContent::Materialize(Node &LazyNode) throw (XmlException)
+{
+    uint32_t index = LazyNode.lazyElement;
+
+    //nodes attached below must not parse the contents again
+    LazyNode.lazyElement = INVALID_ELEMENT;
+
+    try{
+        ParseChildren(LazyNode, index);
+        return;
+    }catch(const Exception &){
+        LazyNode.ClearNodes();
+        LazyNode.value.clear();
+    }
+
+    try{
+        //whole document goes through the reader, so errors get the same text and position as without lazy loading
+        Validate();
+        ParseContent(LazyNode, index);
+    }catch(const Exception &){
+        //next access reports the same error
+        LazyNode.ClearNodes();
+        LazyNode.value.clear();
+        LazyNode.lazyElement = index;
+        throw;
+    }
+}
+
+}
\ No newline at end of file
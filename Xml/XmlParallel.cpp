@@ -0,0 +1,198 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <Xml.h>
+#include <Utils/AutoEvent.h>
+#include <future>
+#include <memory>
+#include <thread>
+
+namespace XML
+{
+
+//smaller parts are not worth a thread
+const size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+//part of the document parsed by a worker into its own tree,
+//spine are the nodes created for the path opened before the chunk
+struct ParsedChunk
+{
+    const char *begin, *end;
+    const ChunkBoundary *start, *finish;
+    Utils::Arena *arena;
+    DocumentContext document;
+    Node *root;
+    std::vector<Node*> spine, opened;
+    std::vector<Atom> atoms;
+    ParsedChunk() : begin(NULL), end(NULL), start(NULL), finish(NULL), arena(NULL), root(NULL){}
+};
+
+static void check_boundary(const XmlReader &Reader, const ChunkBoundary &Boundary) throw (XmlException)
+{
+    if(!Reader.IsIdle() || Reader.GetDepth() != Boundary.path.size())
+        throw XmlException("Invalid chunk boundary");
+
+    for(size_t d = 0; d < Boundary.path.size(); d++)
+        if(Reader.GetOpenedNode(d) != Boundary.path[d])
+            throw XmlException("Invalid chunk boundary");
+}
+
+void XmlData::LoadParallel(const char *Begin, const char *End) throw (XmlException)
+{
+    size_t threadsCount = std::thread::hardware_concurrency();
+    size_t chunksCount = (size_t)(End - Begin) / MIN_CHUNK_SIZE;
+    if(chunksCount > threadsCount)
+        chunksCount = threadsCount;
+
+    ChunkBoundaries boundaries;
+    if(chunksCount > 1)
+        XmlReader::FindBoundaries(Begin, End, (End - Begin) / chunksCount, boundaries);
+
+    if(boundaries.size()){
+        try{
+            ParseChunks(Begin, End, boundaries);
+            return;
+        }catch(const Exception &){
+            //errors get exact positions only from the sequential parse
+            Clear();
+        }
+    }
+
+    DocumentBuilder builder(&rootNode, &header, GetNodesArena(), &document);
+    XmlReader reader(&builder);
+    reader.Parse(Begin, End);
+}
+
+void XmlData::ParseChunk(ParsedChunk &Chunk) throw (XmlException)
+{
+    Chunk.root = Node::Allocate(Chunk.arena, &Chunk.document);
+
+    HeaderData chunkHeader;
+    DocumentBuilder builder(Chunk.root, &chunkHeader, Chunk.arena, &Chunk.document);
+    XmlReader reader(&builder);
+
+    //chunk continues inside the nodes opened before it
+    std::string opening;
+    for(size_t p = 0; p < Chunk.start->path.size(); p++)
+        opening += "<" + Chunk.start->path[p] + ">";
+
+    reader.Parse(opening.data(), opening.data() + opening.size());
+    Chunk.spine = builder.GetProcessingNodes();
+
+    reader.Parse(Chunk.begin, Chunk.end);
+    if(Chunk.finish)
+        check_boundary(reader, *Chunk.finish);
+
+    Chunk.opened = builder.GetProcessingNodes();
+}
+
+void XmlData::RebindNodes(Node *Root, DocumentContext *Document, const std::vector<Atom> &Atoms)
+{
+    Root->document = Document;
+
+    if(Root->nameAtom != INVALID_ATOM)
+        Root->nameAtom = Atoms[Root->nameAtom];
+
+    for(size_t p = 0; p < Root->propertiesAtoms.size(); p++)
+        Root->propertiesAtoms[p].first = Atoms[Root->propertiesAtoms[p].first];
+
+    for(size_t g = 0; g < Root->nodesAtoms.size(); g++)
+        Root->nodesAtoms[g].first = Atoms[Root->nodesAtoms[g].first];
+
+    for(size_t c = 0; c < Root->children.size(); c++)
+        RebindNodes(Root->children[c], Document, Atoms);
+}
+
+void XmlData::ParseChunks(const char *Begin, const char *End, const ChunkBoundaries &Boundaries) throw (XmlException)
+{
+    std::vector<std::unique_ptr<ParsedChunk> > chunks;
+    for(size_t b = 0; b < Boundaries.size(); b++){
+        std::unique_ptr<ParsedChunk> chunk(new ParsedChunk());
+        chunk->begin = Boundaries[b].position;
+        chunk->end = (b + 1 < Boundaries.size()) ? Boundaries[b + 1].position : End;
+        chunk->start = &Boundaries[b];
+        chunk->finish = (b + 1 < Boundaries.size()) ? &Boundaries[b + 1] : NULL;
+
+        if(storageMode == STORAGE_MODE_ARENA){
+            chunk->arena = new Utils::Arena();
+            chunksArenas.push_back(chunk->arena);
+        }
+
+        chunks.push_back(std::move(chunk));
+    }
+
+    //trees not spliced into the document are freed after all workers are done
+    Utils::AutoEvent freeChunks([&chunks](){
+        for(size_t c = 0; c < chunks.size(); c++)
+            if(chunks[c]->root)
+                Node::Free(chunks[c]->root);
+    });
+
+    std::vector<std::future<void> > workers;
+    for(size_t c = 0; c < chunks.size(); c++)
+        workers.push_back(std::async(std::launch::async, &XmlData::ParseChunk, std::ref(*chunks[c])));
+
+    //first part goes right into the document
+    DocumentBuilder builder(&rootNode, &header, GetNodesArena(), &document);
+    XmlReader reader(&builder);
+    reader.Parse(Begin, Boundaries[0].position);
+    check_boundary(reader, Boundaries[0]);
+
+    for(size_t w = 0; w < workers.size(); w++)
+        workers[w].get();
+
+    //names are interned in document order, so atoms are the same as after a sequential parse
+    for(size_t c = 0; c < chunks.size(); c++){
+        const NameTable &names = chunks[c]->document.names;
+
+        chunks[c]->atoms.resize(names.GetSize());
+        for(size_t a = 0; a < names.GetSize(); a++)
+            chunks[c]->atoms[a] = document.names.Intern(names.GetName((Atom)a));
+    }
+
+    workers.clear();
+    for(size_t c = 0; c < chunks.size(); c++)
+        workers.push_back(std::async(std::launch::async, &XmlData::RebindNodes, chunks[c]->root, &document, std::cref(chunks[c]->atoms)));
+
+    for(size_t w = 0; w < workers.size(); w++)
+        workers[w].get();
+
+    std::vector<Node*> opened = builder.GetProcessingNodes();
+    for(size_t c = 0; c < chunks.size(); c++){
+        const std::vector<Node*> &spine = chunks[c]->spine;
+
+        //content of every spine node belongs to the node opened at the same depth
+        for(size_t d = 0; d < spine.size(); d++){
+            Node *synthetic = spine[d];
+            for(size_t n = 0; n < synthetic->children.size(); n++)
+                if(d + 1 == spine.size() || synthetic->children[n] != spine[d + 1])
+                    opened[d]->AttachNode(synthetic->children[n]);
+
+            opened[d]->value += synthetic->value;
+        }
+
+        std::vector<Node*> next = chunks[c]->opened;
+        for(size_t n = 0; n < next.size(); n++)
+            for(size_t d = 0; d < spine.size(); d++)
+                if(next[n] == spine[d])
+                    next[n] = opened[d];
+
+        for(size_t d = 0; d < spine.size(); d++){
+            spine[d]->children.clear();
+            spine[d]->nodes.clear();
+            spine[d]->nodesAtoms.clear();
+        }
+
+        for(size_t d = 0; d < spine.size(); d++)
+            Node::Free(spine[d]);
+
+        chunks[c]->root = NULL;
+        opened.swap(next);
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,909 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <Xml.h>
+#include <Utils/FileGuard.h>
+#include <Utils/MappedFile.h>
+#include <ctype.h>
+#include <string.h>
+#include <sstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define XML_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XML_SCAN_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace XML
+{
+
+enum ScanMode
+{
+    SCAN_MODE_STRING,
+    SCAN_MODE_STRUCTURE,
+    SCAN_MODE_DATA,
+    SCAN_MODE_MARKUP
+};
+
+//string literals end only on quote or shield char, structure scan additionally on markup start,
+//node data also on markup end and dropped whitespaces ('/', '?', '=' and ' ' are plain text there),
+//markup on every special char
+template<ScanMode Mode>
+static bool is_delimiter(char Char)
+{
+    switch(Char){
+        case '"': case '\\':
+            return true;
+        case '<':
+            return Mode != SCAN_MODE_STRING;
+        case '>': case '\t': case '\n': case '\v': case '\f': case '\r':
+            return Mode == SCAN_MODE_DATA || Mode == SCAN_MODE_MARKUP;
+        case '/': case ' ': case '?': case '=':
+            return Mode == SCAN_MODE_MARKUP;
+        default:
+            return false;
+    }
+}
+
+//same chars as isspace in the C locale, plus the markup ones
+static inline bool is_name_char(char Char)
+{
+    switch(Char){
+        case ' ': case '\t': case '\n': case '\v': case '\f': case '\r':
+        case '/': case '<': case '>': case '?': case '=': case '"': case '\\':
+            return false;
+        default:
+            return true;
+    }
+}
+
+#if defined(XML_SCAN_AVX2) || defined(XML_SCAN_SSE2)
+
+#ifdef XML_SCAN_AVX2
+typedef __m256i scan_vector;
+static const size_t scanWidth = 32;
+static inline scan_vector scan_load(const char *Data) {return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Data));}
+static inline scan_vector scan_splat(char Char) {return _mm256_set1_epi8(Char);}
+static inline scan_vector scan_eq(scan_vector A, scan_vector B) {return _mm256_cmpeq_epi8(A, B);}
+static inline scan_vector scan_or(scan_vector A, scan_vector B) {return _mm256_or_si256(A, B);}
+static inline scan_vector scan_sub(scan_vector A, scan_vector B) {return _mm256_sub_epi8(A, B);}
+static inline scan_vector scan_min(scan_vector A, scan_vector B) {return _mm256_min_epu8(A, B);}
+static inline uint32_t scan_mask(scan_vector A) {return (uint32_t)_mm256_movemask_epi8(A);}
+#else
+typedef __m128i scan_vector;
+static const size_t scanWidth = 16;
+static inline scan_vector scan_load(const char *Data) {return _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data));}
+static inline scan_vector scan_splat(char Char) {return _mm_set1_epi8(Char);}
+static inline scan_vector scan_eq(scan_vector A, scan_vector B) {return _mm_cmpeq_epi8(A, B);}
+static inline scan_vector scan_or(scan_vector A, scan_vector B) {return _mm_or_si128(A, B);}
+static inline scan_vector scan_sub(scan_vector A, scan_vector B) {return _mm_sub_epi8(A, B);}
+static inline scan_vector scan_min(scan_vector A, scan_vector B) {return _mm_min_epu8(A, B);}
+static inline uint32_t scan_mask(scan_vector A) {return (uint32_t)_mm_movemask_epi8(A);}
+#endif
+
+static inline uint32_t first_bit(uint32_t Mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, Mask);
+    return index;
+#else
+    return __builtin_ctz(Mask);
+#endif
+}
+
+template<ScanMode Mode>
+static inline scan_vector delimiters_mask(scan_vector Chars)
+{
+    scan_vector mask = scan_or(scan_eq(Chars, scan_splat('"')), scan_eq(Chars, scan_splat('\\')));
+    if(Mode == SCAN_MODE_STRING)
+        return mask;
+
+    if(Mode == SCAN_MODE_STRUCTURE)
+        return scan_or(mask, scan_eq(Chars, scan_splat('<')));
+
+    //'\t'..'\r' are contiguous, so one unsigned range check covers them
+    scan_vector shifted = scan_sub(Chars, scan_splat('\t'));
+    scan_vector controlSpaces = scan_eq(scan_min(shifted, scan_splat('\r' - '\t')), shifted);
+
+    mask = scan_or(mask, controlSpaces);
+    mask = scan_or(mask, scan_or(scan_eq(Chars, scan_splat('<')), scan_eq(Chars, scan_splat('>'))));
+    if(Mode == SCAN_MODE_DATA)
+        return mask;
+
+    mask = scan_or(mask, scan_or(scan_eq(Chars, scan_splat('/')), scan_eq(Chars, scan_splat(' '))));
+    return scan_or(mask, scan_or(scan_eq(Chars, scan_splat('?')), scan_eq(Chars, scan_splat('='))));
+}
+
+#endif
+
+template<ScanMode Mode>
+static const char *find_delimiter(const char *Begin, const char *End)
+{
+    const char *pos = Begin;
+
+#if defined(XML_SCAN_AVX2) || defined(XML_SCAN_SSE2)
+    for(; (size_t)(End - pos) >= scanWidth; pos += scanWidth){
+        uint32_t mask = scan_mask(delimiters_mask<Mode>(scan_load(pos)));
+        if(mask)
+            return pos + first_bit(mask);
+    }
+#endif
+
+    while(pos != End && !is_delimiter<Mode>(*pos))
+        ++pos;
+
+    return pos;
+}
+
+void XmlReader::Token::Append(const char *Begin, const char *End)
+{
+    if(Begin == End)
+        return;
+
+    if(!buffered){
+        if(!length){
+            begin = Begin;
+            length = End - Begin;
+            return;
+        }
+
+        if(begin + length == Begin){
+            length += End - Begin;
+            return;
+        }
+
+        buffer.assign(begin, length);
+        buffered = true;
+    }
+
+    buffer.append(Begin, End);
+    length = buffer.length();
+}
+
+void XmlReader::Token::Detach()
+{
+    if(buffered || !length)
+        return;
+
+    buffer.assign(begin, length);
+    buffered = true;
+}
+
+void XmlReader::Token::Clear()
+{
+    begin = NULL;
+    length = 0;
+    buffered = false;
+    buffer.clear();
+}
+
+XmlReader::XmlReader(IXmlHandler *Handler) : handler(Handler)
+{
+    Reset();
+}
+
+void XmlReader::Reset()
+{
+    state = STATE_IDLE;
+    structState = STRUCT_STATE_NODE_DEFINITION;
+    headerState = HEADER_STATE_NOT_SET;
+
+    stringState = shieldChar = isSingleNode = nodeClosed = varAsEmptyStr = false;
+    nodeStarted = rootStarted = headerRead = false;
+
+    text.Clear();
+    varName.Clear();
+    varData.Clear();
+    tagName.Clear();
+
+    nodeName.clear();
+    header.clear();
+    depth = 0;
+
+    cursor.Clear();
+}
+
+void XmlReader::FlushNodeName() throw (XmlException)
+{
+    if(tagName.Empty())
+        return;
+
+    if(nodeStarted)
+        throw cursor.CreateException("Invalid node name");
+
+    nodeName.append(tagName.GetData(), tagName.GetLength());
+    tagName.Clear();
+}
+
+void XmlReader::FlushProperty() throw (XmlException)
+{
+    propName.assign(varName.GetData(), varName.GetLength());
+    propValue.assign(varData.GetData(), varData.GetLength());
+
+    varName.Clear();
+    varData.Clear();
+
+    if(headerState != HEADER_STATE_NOT_SET){
+        if(!header.insert(std::make_pair(propName, propValue)).second)
+            throw PropertyExistException(std::string("Property ") + propName + " already exist in node " + nodeName);
+
+        return;
+    }
+
+    //closing tags carry no properties
+    if(nodeClosed && !isSingleNode)
+        return;
+
+    if(!nodeStarted)
+        StartNode();
+
+    handler->OnProperty(propName, propValue);
+}
+
+void XmlReader::FlushText() throw (XmlException)
+{
+    textData.assign(text.GetData(), text.GetLength());
+    text.Clear();
+
+    if(depth){
+        handler->OnText(textData);
+        return;
+    }
+
+    //only spaces are allowed around the root node
+    if(textData.find_first_not_of(' ') != std::string::npos)
+        throw cursor.CreateException("Invalid syntax");
+}
+
+void XmlReader::StartNode() throw (XmlException)
+{
+    if(nodeName.empty())
+        throw cursor.CreateException("Empty node name");
+
+    if(!depth && rootStarted)
+        throw cursor.CreateException("Invalid root node");
+
+    rootStarted = nodeStarted = true;
+
+    handler->OnNodeStart(nodeName);
+}
+
+void XmlReader::DetachTokens()
+{
+    text.Detach();
+    varName.Detach();
+    varData.Detach();
+    tagName.Detach();
+}
+
+void XmlReader::ProcessNodeDefinitionStart() throw (XmlException)
+{
+    if(state != STATE_IDLE)
+        throw cursor.CreateException("Invalid syntax");
+
+    if(!text.Empty())
+        FlushText();
+
+    nodeName.clear();
+    nodeStarted = false;
+
+    state = STATE_NODE_NAME;
+    structState = STRUCT_STATE_NODE_DEFINITION;
+}
+
+void XmlReader::Cursor::Advance(const char *Begin, const char *End, int &Line, int &Coll)
+{
+    const char *lineEnd;
+    while(Begin < End && (lineEnd = static_cast<const char*>(memchr(Begin, '\n', End - Begin))) != NULL){
+        Line++;
+        Coll = 1;
+        Begin = lineEnd + 1;
+    }
+
+    if(Begin < End)
+        Coll += (int)(End - Begin);
+}
+
+void XmlReader::Cursor::EndBlock(const char *End)
+{
+    Advance(blockBegin, End, line, coll);
+    blockBegin = position = NULL;
+}
+
+XmlSyntaxException XmlReader::Cursor::CreateException(const std::string &Message) const
+{
+    //position is resolved only here, parsing itself just remembers the last processed char
+    int errLine = line, errColl = coll;
+    Advance(blockBegin, position, errLine, errColl);
+
+    std::stringstream sstrm;
+    sstrm << Message << ", Line " << errLine << " Coll " << errColl;
+    return XmlSyntaxException(sstrm.str());
+}
+
+void XmlReader::ProcessNodeDefinitionEnd() throw (XmlException)
+{
+    FlushNodeName();
+
+    if(nodeName == "")
+        throw cursor.CreateException("Empty node name");
+
+    if(!varName.Empty())
+        FlushProperty();
+
+    if(headerState != HEADER_STATE_NOT_SET){
+        if(nodeName != "xml")
+            throw cursor.CreateException("Invalid header name");
+
+        if(headerState != HEADER_STATE_END)
+            throw cursor.CreateException("Invalid header syntax");
+
+        handler->OnHeader(header);
+        header.clear();
+
+        headerRead = true;
+        headerState = HEADER_STATE_NOT_SET;
+    }else{
+
+        if(!isSingleNode)
+            if(nodeClosed){                        
+                if(!depth || openedNodes[depth - 1] != nodeName)
+                    throw cursor.CreateException("Invalid closing node syntax");
+
+                depth--;
+                handler->OnNodeEnd(nodeName);
+            }else{
+                if(!nodeStarted)
+                    StartNode();
+
+                OpenNode();
+            }
+        else{
+            if(!depth)
+                throw cursor.CreateException("Invalid single node");
+
+            if(!nodeStarted)
+                StartNode();
+
+            handler->OnNodeEnd(nodeName);
+        }
+    }
+
+    FinishTag();
+}
+
+void XmlReader::OpenNode()
+{
+    //names of closed nodes are kept, so their buffers get reused by the next nodes on that level
+    if(depth == openedNodes.size())
+        openedNodes.push_back(nodeName);
+    else
+        openedNodes[depth] = nodeName;
+
+    depth++;
+}
+
+void XmlReader::FinishTag()
+{
+    nodeClosed = isSingleNode = varAsEmptyStr = false;
+    structState = STRUCT_STATE_NODE_DATA;
+    state = STATE_IDLE;
+}
+
+void XmlReader::ProcessSlash(const char *Char) throw (XmlException)
+{
+    if(structState == STRUCT_STATE_NODE_DATA){
+        text.Append(Char, Char + 1);
+        return;
+    }
+
+    if(state == STATE_IDLE)
+        throw cursor.CreateException("Invalid slash syntax");
+
+    FlushNodeName();
+
+    isSingleNode = nodeName != "";
+
+    nodeClosed = true;
+}
+
+void XmlReader::ProcessSpace(const char *Char) throw (XmlException)
+{
+    if(structState == STRUCT_STATE_NODE_DATA){
+       text.Append(Char, Char + 1);
+       return;
+    }
+
+    //spaces before the first node
+    if(state == STATE_IDLE)
+        return;
+
+    FlushNodeName();
+
+    if(nodeName == "")
+        state = STATE_NODE_NAME;
+    else if(!varData.Empty() || varAsEmptyStr){
+        FlushProperty();
+        state = STATE_NODE_ATTR_NAME;
+        varAsEmptyStr = false;
+    }else if(state != STATE_NODE_ATTR_VAL)
+        state = STATE_NODE_ATTR_NAME;
+}
+
+void XmlReader::ProcessQuestionChar(const char *Char) throw (XmlException)
+{
+    if(structState == STRUCT_STATE_NODE_DATA){
+        text.Append(Char, Char + 1);
+        return;
+    }
+
+    if(state == STATE_IDLE)
+        throw cursor.CreateException("Invalid header syntax");
+
+    FlushNodeName();
+
+    if(headerState == HEADER_STATE_NOT_SET)
+        if(depth || rootStarted || headerRead || nodeName != "")
+            throw cursor.CreateException("Invalid header syntax");
+            
+    headerState = (headerState == HEADER_STATE_BEGIN) ? HEADER_STATE_END : HEADER_STATE_BEGIN;
+}
+
+void XmlReader::ProcessEqualChar(const char *Char) throw (XmlException)
+{
+    if(structState == STRUCT_STATE_NODE_DATA){        
+        text.Append(Char, Char + 1);
+        return;
+    }
+        
+    if(state != STATE_NODE_ATTR_NAME)
+        throw cursor.CreateException("Invalid property syntax");
+
+    state = STATE_NODE_ATTR_VAL;
+}
+
+void XmlReader::ProcessChar(const char *Char) throw (XmlException)
+{
+    const char ch = *Char;
+
+    cursor.SetPosition(Char);
+
+    if(ch == '"'){
+        stringState = !stringState;
+
+        if(!stringState && state == STATE_NODE_ATTR_VAL && varData.Empty())
+            varAsEmptyStr = true;
+
+        return;
+    }
+
+    if(ch == '\\'){
+        if(!stringState)
+            throw cursor.CreateException("Slash out of the string");
+
+        shieldChar = !shieldChar;
+        return;
+    }
+
+    if(stringState || shieldChar){
+        if(state == STATE_IDLE)
+            text.Append(Char, Char + 1);
+        else if(state == STATE_NODE_ATTR_VAL)
+            varData.Append(Char, Char + 1);
+        else 
+            throw cursor.CreateException("Invalid literal");
+    
+        if(shieldChar)
+            shieldChar = false;
+        return;
+    }
+
+    if(ch == '<'){
+        ProcessNodeDefinitionStart();
+    }else if(ch == '>'){
+       ProcessNodeDefinitionEnd();
+    }else if(ch == '/'){
+        ProcessSlash(Char);
+    }else if(ch == ' '){
+        ProcessSpace(Char);
+    }else if(ch == '?'){
+        ProcessQuestionChar(Char);
+    }else if(ch == '='){
+        ProcessEqualChar(Char);
+    }else if(!isspace((unsigned char)ch)){
+        if(state == STATE_NODE_NAME)
+            tagName.Append(Char, Char + 1);
+        else if(state == STATE_NODE_ATTR_NAME)
+            varName.Append(Char, Char + 1);
+        else if(state == STATE_NODE_ATTR_VAL)
+            varData.Append(Char, Char + 1);
+        else
+            text.Append(Char, Char + 1);
+    }
+}
+
+const char *XmlReader::ProcessRun(const char *Begin, const char *End) throw (XmlException)
+{
+    //consumes a run of chars which all go to the same token without changing parser state,
+    //so the token grows once per run instead of once per char
+    if(shieldChar)
+        return Begin;
+
+    Token *token = NULL;
+    const char *pos = Begin;
+
+    if(stringState){
+        if(state == STATE_IDLE)
+            token = &text;
+        else if(state == STATE_NODE_ATTR_VAL)
+            token = &varData;
+        else
+            return Begin;
+
+        pos = find_delimiter<SCAN_MODE_STRING>(Begin, End);
+    }else{
+        if(state == STATE_NODE_NAME)
+            token = &tagName;
+        else if(state == STATE_NODE_ATTR_NAME)
+            token = &varName;
+        else if(state == STATE_NODE_ATTR_VAL)
+            token = &varData;
+        else
+            token = &text;
+
+        if(structState == STRUCT_STATE_NODE_DATA && state == STATE_IDLE)
+            pos = find_delimiter<SCAN_MODE_DATA>(Begin, End);
+        else
+            pos = find_delimiter<SCAN_MODE_MARKUP>(Begin, End);
+    }
+
+    token->Append(Begin, pos);
+
+    return pos;
+}
+
+const char *XmlReader::ProcessTag(const char *Begin, const char *End) throw (XmlException)
+{
+    //tag completely inside the block, with names and quoted values without shield chars separated by spaces,
+    //goes right from the block to the handler. Everything else, errors too, is left to the char by char path
+    if(state != STATE_IDLE || stringState || shieldChar || headerState != HEADER_STATE_NOT_SET)
+        return Begin;
+
+    const char *pos = Begin + 1;
+    bool closing = pos != End && *pos == '/';
+    if(closing)
+        pos++;
+
+    const char *nameBegin = pos;
+    while(pos != End && is_name_char(*pos))
+        pos++;
+
+    const char *nameEnd = pos;
+    if(nameBegin == nameEnd)
+        return Begin;
+
+    tagProperties.clear();
+    bool single = false;
+
+    for(;;){
+        if(pos == End)
+            return Begin;
+
+        if(*pos == '>')
+            break;
+
+        if(*pos == '/'){
+            if(closing || ++pos == End || *pos != '>')
+                return Begin;
+
+            single = true;
+            break;
+        }
+
+        if(*pos != ' ')
+            return Begin;
+
+        while(++pos != End && *pos == ' ');
+
+        if(pos == End || *pos == '>' || *pos == '/')
+            continue;
+
+        if(closing)
+            return Begin;
+
+        TagProperty property;
+        property.nameBegin = pos;
+        while(pos != End && is_name_char(*pos))
+            pos++;
+
+        property.nameEnd = pos;
+        if(property.nameBegin == property.nameEnd || pos == End || *pos != '=' || ++pos == End || *pos != '"')
+            return Begin;
+
+        property.valueBegin = ++pos;
+        pos = find_delimiter<SCAN_MODE_STRING>(pos, End);
+        if(pos == End || *pos != '"')
+            return Begin;
+
+        property.valueEnd = pos++;
+        tagProperties.push_back(property);
+    }
+
+    size_t nameLength = nameEnd - nameBegin;
+    if(closing && (!depth || openedNodes[depth - 1].compare(0, std::string::npos, nameBegin, nameLength)))
+        return Begin;
+
+    if(!closing && (single ? !depth : !depth && rootStarted))
+        return Begin;
+
+    cursor.SetPosition(Begin);
+    ProcessNodeDefinitionStart();
+
+    nodeName.assign(nameBegin, nameLength);
+
+    if(closing){
+        depth--;
+        handler->OnNodeEnd(nodeName);
+    }else{
+        StartNode();
+
+        for(size_t p = 0; p < tagProperties.size(); p++){
+            propName.assign(tagProperties[p].nameBegin, tagProperties[p].nameEnd);
+            propValue.assign(tagProperties[p].valueBegin, tagProperties[p].valueEnd);
+            handler->OnProperty(propName, propValue);
+        }
+
+        if(single)
+            handler->OnNodeEnd(nodeName);
+        else
+            OpenNode();
+    }
+
+    FinishTag();
+    cursor.SetPosition(pos);
+
+    return pos + 1;
+}
+
+void XmlReader::Parse(const char *Begin, const char *End) throw (XmlException)
+{
+    const char *pos = Begin;
+
+    cursor.BeginBlock(Begin);
+
+    while(pos != End){
+        const char *runEnd = ProcessRun(pos, End);
+        if(runEnd != pos)
+            pos = runEnd;
+        else if(*pos == '<' && (runEnd = ProcessTag(pos, End)) != pos)
+            pos = runEnd;
+        else
+            ProcessChar(pos++);
+    }
+
+    //block belongs to the caller and can be overwritten after return
+    DetachTokens();
+    cursor.EndBlock(End);
+}
+
+void XmlReader::ReadFile(const std::string &FilePath, LoadMode Mode) throw (XmlException)
+{
+    //reader itself is sequential, parallel loading is done by XmlData
+    if(Mode != LOAD_MODE_BUFFERED){
+        Utils::MappedFile file(FilePath);
+
+        Reset();
+        Parse(file.begin(), file.end());
+        return;
+    }
+
+    Utils::FileGuard file(FilePath, "r");
+
+    Reset();
+
+    const size_t blockSize = 1024;
+    char block[blockSize];
+
+    while(!feof(file.get())){
+        size_t nRead = fread(block, 1, blockSize, file.get());
+        Parse(block, block + nRead);
+    }
+}
+
+void XmlReader::ReadString(const std::string &DataString) throw (XmlException)
+{
+    Reset();
+    Parse(DataString.data(), DataString.data() + DataString.size());
+}
+
+bool XmlReader::IsIdle() const
+{
+    return state == STATE_IDLE && structState == STRUCT_STATE_NODE_DATA && !stringState && !shieldChar && headerState == HEADER_STATE_NOT_SET;
+}
+
+static const char *skip_string(const char *Begin, const char *End)
+{
+    //shield char does not protect quotes, so a literal ends on the very next one
+    const char *quote = static_cast<const char*>(memchr(Begin, '"', End - Begin));
+    return quote ? quote + 1 : End;
+}
+
+void XmlReader::FindBoundaries(const char *Begin, const char *End, size_t ChunkSize, ChunkBoundaries &Boundaries)
+{
+    //rough structure pass, reader verifies every boundary while parsing the chunks
+    std::vector<std::pair<const char*, size_t> > path;
+    const char *pos = Begin, *lastBoundary = Begin;
+
+    while(pos != End){
+        pos = find_delimiter<SCAN_MODE_STRUCTURE>(pos, End);
+        if(pos == End)
+            break;
+
+        if(*pos == '"'){
+            pos = skip_string(pos + 1, End);
+            continue;
+        }
+
+        if(*pos++ != '<')
+            continue;
+
+        while(pos != End && *pos == ' ')
+            pos++;
+
+        bool header = pos != End && *pos == '?';
+        bool closing = pos != End && *pos == '/';
+        bool single = false;
+
+        if(closing)
+            while(++pos != End && *pos == ' ');
+
+        const char *name = pos;
+        while(pos != End && is_name_char(*pos))
+            pos++;
+
+        size_t nameLength = pos - name;
+
+        while(pos != End && *pos != '>'){
+            if(*pos == '"'){
+                pos = skip_string(pos + 1, End);
+                continue;
+            }
+
+            single = single || *pos == '/';
+            pos++;
+        }
+
+        if(pos == End)
+            break;
+
+        pos++;
+
+        if(!header && !single){
+            if(!closing){
+                path.push_back(std::make_pair(name, nameLength));
+                continue;
+            }
+
+            //end of root node
+            if(path.size() < 2)
+                break;
+
+            path.pop_back();
+        }
+
+        if(!path.size() || (size_t)(pos - lastBoundary) < ChunkSize)
+            continue;
+
+        ChunkBoundary boundary;
+        boundary.position = pos;
+        for(size_t p = 0; p < path.size(); p++)
+            boundary.path.push_back(std::string(path[p].first, path[p].second));
+
+        Boundaries.push_back(boundary);
+        lastBoundary = pos;
+    }
+}
+
+void XmlReader::ScanElements(const char *Begin, const char *End, ElementRanges &Elements) throw (XmlException)
+{
+    //bounds of every element, the reader checks contents when they are parsed
+    if((uint64_t)(End - Begin) >= INVALID_ELEMENT)
+        throw XmlException("Document is too large for lazy loading");
+
+    std::vector<std::pair<const char*, size_t> > names;
+    std::vector<uint32_t> path;
+    const char *pos = Begin;
+
+    while(pos != End){
+        pos = find_delimiter<SCAN_MODE_STRUCTURE>(pos, End);
+        if(pos == End)
+            break;
+
+        if(*pos == '"'){
+            pos = skip_string(pos + 1, End);
+            continue;
+        }
+
+        const char *tagBegin = pos;
+        if(*pos++ != '<')
+            continue;
+
+        while(pos != End && *pos == ' ')
+            pos++;
+
+        bool header = pos != End && *pos == '?';
+        bool closing = pos != End && *pos == '/';
+        bool single = false;
+
+        if(closing)
+            while(++pos != End && *pos == ' ');
+
+        const char *name = pos;
+        while(pos != End && is_name_char(*pos))
+            pos++;
+
+        size_t nameLength = pos - name;
+
+        while(pos != End && *pos != '>'){
+            if(*pos == '"'){
+                pos = skip_string(pos + 1, End);
+                continue;
+            }
+
+            single = single || *pos == '/';
+            pos++;
+        }
+
+        if(pos == End)
+            break;
+
+        pos++;
+
+        if(header)
+            continue;
+
+        uint32_t offset = (uint32_t)(pos - Begin);
+
+        if(closing){
+            //reader decides what such tags mean
+            if(!path.size() || names.back().second != nameLength || memcmp(names.back().first, name, nameLength))
+                throw XmlException("Unbalanced element " + std::string(name, nameLength));
+
+            ElementRange &element = Elements[path.back()];
+            element.contentEnd = (uint32_t)(tagBegin - Begin);
+            element.end = offset;
+            element.next = (uint32_t)Elements.size();
+
+            path.pop_back();
+            names.pop_back();
+            continue;
+        }
+
+        ElementRange element = {offset, offset, offset, (uint32_t)Elements.size() + 1, single};
+        if(!single){
+            path.push_back((uint32_t)Elements.size());
+            names.push_back(std::make_pair(name, nameLength));
+        }
+
+        Elements.push_back(element);
+    }
+
+    //reader accepts nodes left open at the end of the document
+    for(size_t p = 0; p < path.size(); p++){
+        ElementRange &element = Elements[path[p]];
+        element.contentEnd = element.end = (uint32_t)(End - Begin);
+        element.next = (uint32_t)Elements.size();
+    }
+}
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+#include <Xml.h>
+
+namespace XML
+{
+
+XmlWriter::XmlWriter(int32_t Indent) :
+    file(NULL),
+    flushSize(0),
+    indent(Indent),
+    level(0),
+    tagOpened(false)
+{}
+
+XmlWriter::XmlWriter(FILE *File, int32_t Indent, size_t FlushSize) :
+    file(File),
+    flushSize(FlushSize),
+    indent(Indent),
+    level(0),
+    tagOpened(false)
+{
+    buffer.reserve(FlushSize);
+}
+
+XmlWriter::~XmlWriter()
+{
+    //errors can be caught only with explicit Flush
+    if(file && buffer.size())
+        fwrite(buffer.c_str(), 1, buffer.size(), file);
+}
+
+void XmlWriter::CloseTag()
+{
+    if(!tagOpened)
+        return;
+
+    buffer += ">\n";
+    tagOpened = false;
+}
+
+void XmlWriter::FlushBuffer() throw (XmlException)
+{
+    if(file && buffer.size() >= flushSize)
+        Flush();
+}
+
+void XmlWriter::Flush() throw (XmlException)
+{
+    if(!file || !buffer.size())
+        return;
+
+    if(fwrite(buffer.c_str(), 1, buffer.size(), file) != buffer.size())
+        throw XmlException("cant write to file");
+
+    buffer.clear();
+}
+
+std::string XmlWriter::TakeData()
+{
+    std::string data;
+    data.swap(buffer);
+    return data;
+}
+
+void XmlWriter::WriteHeader(const HeaderData &Header) throw (XmlException)
+{
+    WriteIndent();
+    buffer += "<?xml";
+
+    HeaderData::const_iterator ci;
+    for(ci = Header.begin(); ci != Header.end(); ++ci){
+        buffer += ' ';
+        buffer += ci->first;
+        buffer += "=\"";
+        buffer += ci->second;
+        buffer += '"';
+    }
+
+    buffer += "?>\n";
+
+    FlushBuffer();
+}
+
+void XmlWriter::StartNode(const std::string &Name) throw (XmlException)
+{
+    CloseTag();
+
+    WriteIndent();
+    buffer += '<';
+    buffer += Name;
+
+    tagOpened = true;
+    openedNodes.push_back(Name);
+    level++;
+}
+
+void XmlWriter::WriteProperty(const std::string &Name, const std::string &Value) throw (XmlException)
+{
+    if(!tagOpened)
+        throw XmlException("Property " + Name + " out of node definition");
+
+    buffer += ' ';
+    buffer += Name;
+    buffer += "=\"";
+    buffer += Value;
+    buffer += '"';
+}
+
+void XmlWriter::WriteText(const std::string &Text) throw (XmlException)
+{
+    if(!openedNodes.size())
+        throw XmlException("Text out of node");
+
+    CloseTag();
+
+    WriteIndent();
+    buffer += Text;
+    buffer += '\n';
+
+    FlushBuffer();
+}
+
+void XmlWriter::EndNode() throw (XmlException)
+{
+    if(!openedNodes.size())
+        throw XmlException("No opened nodes");
+
+    level--;
+
+    if(tagOpened){
+        buffer += "/>\n";
+        tagOpened = false;
+    }else{
+        WriteIndent();
+        buffer += "</";
+        buffer += openedNodes.back();
+        buffer += ">\n";
+    }
+
+    openedNodes.pop_back();
+
+    FlushBuffer();
+}
+
+void XmlWriter::WriteNode(const Node &WritingNode) throw (XmlException)
+{
+    WritingNode.Materialize();
+
+    StartNode(WritingNode.name);
+
+    Node::PropertiesStorage::const_iterator ci;
+    for(ci = WritingNode.properties.begin(); ci != WritingNode.properties.end(); ++ci)
+        WriteProperty(ci->first, ci->second);
+
+    //value line is written even if empty when the node has children
+    if(WritingNode.children.size() || WritingNode.value.size())
+        WriteText(WritingNode.value);
+
+    for(size_t c = 0; c < WritingNode.children.size(); c++)
+        WriteNode(*WritingNode.children[c]);
+
+    EndNode();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+//checks of XML::XmlData that are the same in every load and storage mode
+
+#include <Xml.h>
+#include <Serializing.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool Condition, const std::string &What)
+{
+    if(Condition)
+        return;
+
+    std::cerr << "FAILED: " << What << std::endl;
+    failures++;
+}
+
+static const char TEST_DOCUMENT[] =
+    "<?xml version=\"1.0\"?>\n"
+    "<root>\n"
+    "  <points>\n"
+    "    <point x=\"1\" y=\"0.5\"/>\n"
+    "    <point x=\"-2\" y=\"1.5\"/>\n"
+    "    <point x=\"3\" y=\"-2.25\"/>\n"
+    "  </points>\n"
+    "  <group roll=\"{1,2,3,4,5,6,7,8,9,10}\"><item id=\"7\">text</item></group>\n"
+    "</root>";
+
+static size_t walk(const XML::Node &Root)
+{
+    size_t visited = 1;
+
+    XML::ConstNodeIterator it;
+    for(it = Root.begin(); it != Root.end(); ++it)
+        visited += walk(*it);
+
+    return visited;
+}
+
+static void test_typed_getters(XML::LoadMode Mode, const std::string &ModeName)
+{
+    XML::XmlData data;
+    data.LoadFromString(TEST_DOCUMENT, Mode);
+
+    const XML::Node &points = *data.GetRoot().begin();
+
+    std::vector<int32_t> ints;
+    points.GetInts("point", "x", ints);
+    check(ints.size() == 3 && ints[0] == 1 && ints[1] == -2 && ints[2] == 3, "GetInts by name, " + ModeName);
+
+    std::vector<float> floats;
+    points.GetFloats("point", "y", floats);
+    check(floats.size() == 3 && floats[0] == 0.5f && floats[1] == 1.5f && floats[2] == -2.25f, "GetFloats by name, " + ModeName);
+
+    XML::XmlData atomData;
+    atomData.LoadFromString(TEST_DOCUMENT, Mode);
+
+    const XML::Node &atomPoints = *atomData.GetRoot().begin();
+    atomPoints.GetInts(atomData.GetAtom("point"), atomData.GetAtom("x"), ints);
+    check(ints.size() == 3 && ints[2] == 3, "GetInts by atom, " + ModeName);
+
+    points.GetInts("missing", "x", ints);
+    check(ints.empty(), "GetInts of missing nodes, " + ModeName);
+
+    const XML::Node &item = data.GetRoot().GetNode("group").GetNode("item");
+    check(item.Get<IntParser>("id") == 7 && item.Get<IntParser>("id") == 7, "Get of a number, " + ModeName);
+
+    //random choices are not cached, ten reads of one value happen once in a billion
+    const XML::Node &group = data.GetRoot().GetNode("group");
+    int32_t first = group.Get<IntParser>("roll");
+    bool varies = false;
+    for(int r = 0; r < 10; r++)
+        varies = varies || group.Get<IntParser>("roll") != first;
+
+    check(varies, "Get of a random choice, " + ModeName);
+}
+
+static void test_arena_storage(XML::LoadMode Mode, const std::string &ModeName)
+{
+    XML::XmlData data(XML::XmlData::STORAGE_MODE_ARENA);
+    data.LoadFromString(TEST_DOCUMENT, Mode);
+
+    check(walk(data.GetRoot()) == 7, "nodes count, " + ModeName);
+    check(data.GetNodesArenaSize() > 0, "nodes are allocated from the arena, " + ModeName);
+
+    XML::XmlData heapData(XML::XmlData::STORAGE_MODE_HEAP);
+    heapData.LoadFromString(TEST_DOCUMENT, Mode);
+
+    check(walk(heapData.GetRoot()) == 7 && heapData.GetNodesArenaSize() == 0, "heap storage does not use the arena, " + ModeName);
+}
+
+static const char OTHER_DOCUMENT[] =
+    "<other><points><point x=\"100\" y=\"200\"/></points><group><item id=\"9\">other</item></group></other>";
+
+static bool is_test_tree(const XML::Node &Root)
+{
+    return walk(Root) == 7 && Root.GetChildrenCount() == 2 &&
+           Root.GetNode("group").GetNode("item").GetProperty("id") == "7" &&
+           Root.GetNode("group").GetNode("item").GetValue() == "text";
+}
+
+static void test_arena_moves(XML::LoadMode Mode, const std::string &ModeName)
+{
+    XML::Node assigned;
+    std::unique_ptr<XML::Node> constructed;
+    XML::SharedNode shared;
+    XML::Node points;
+
+    {
+        //every load goes to its own document, so a moved out root cant hide a copy of another one
+        XML::XmlData first(XML::XmlData::STORAGE_MODE_ARENA), second(XML::XmlData::STORAGE_MODE_ARENA),
+                     third(XML::XmlData::STORAGE_MODE_ARENA), fourth(XML::XmlData::STORAGE_MODE_ARENA);
+        first.LoadFromString(TEST_DOCUMENT, Mode);
+        second.LoadFromString(TEST_DOCUMENT, Mode);
+        third.LoadFromString(TEST_DOCUMENT, Mode);
+        fourth.LoadFromString(TEST_DOCUMENT, Mode);
+
+        assigned = std::move(first.GetRoot());
+        constructed.reset(new XML::Node(std::move(second.GetRoot())));
+        shared = XML::Node::Share(std::move(third.GetRoot()));
+        points.AddNode(std::move(fourth.GetRoot().GetNode("points")));
+    }
+
+    //memory of the freed arenas is reused by another document
+    XML::XmlData other(XML::XmlData::STORAGE_MODE_ARENA);
+    other.LoadFromString(OTHER_DOCUMENT, Mode);
+    check(walk(other.GetRoot()) == 5, "other document, " + ModeName);
+
+    check(is_test_tree(assigned), "root moved out of an arena document, " + ModeName);
+    check(is_test_tree(*constructed), "root moved into a new node from an arena document, " + ModeName);
+    check(is_test_tree(*shared), "root shared from an arena document, " + ModeName);
+
+    std::vector<int32_t> ints;
+    points.GetNode("points").GetInts("point", "x", ints);
+    check(ints.size() == 3 && ints[1] == -2, "node added from an arena document, " + ModeName);
+
+    XML::XmlData target(XML::XmlData::STORAGE_MODE_ARENA);
+    target.LoadFromString("<target></target>", Mode);
+    target.GetRoot().AddNode(shared);
+    target.GetRoot().AddNode(std::move(assigned));
+    check(is_test_tree(target.GetRoot().GetChild(0)) && is_test_tree(target.GetRoot().GetChild(1)),
+          "nodes from an arena document added to another one, " + ModeName);
+}
+
+int main()
+{
+    try{
+        const XML::LoadMode modes[] = {XML::LOAD_MODE_BUFFERED, XML::LOAD_MODE_LAZY};
+        const char *modeNames[] = {"buffered", "lazy"};
+
+        for(int m = 0; m < 2; m++){
+            test_typed_getters(modes[m], modeNames[m]);
+            test_arena_storage(modes[m], modeNames[m]);
+            test_arena_moves(modes[m], modeNames[m]);
+        }
+
+    }catch(const Exception &ex){
+        std::cerr << ex.What() << std::endl;
+        return 1;
+    }
+
+    if(failures)
+        return 1;
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
\ No newline at end of file
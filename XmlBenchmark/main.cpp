@@ -0,0 +1,492 @@
+/*******************************************************************************
+    Author: Alexey Frolov (alexwin32@mail.ru)
+
+    This software is distributed freely under the terms of the MIT License.
+    See "LICENSE" or "http://copyfree.org/content/standard/licenses/mit/license.txt".
+*******************************************************************************/
+
+//throughput of XML::XmlData on generated documents and on the files given in the command line
+//
+//usage: XmlBenchmark [--sizes 1K,64K,1M] [--full] [--quick] [--time Seconds] [--tmp Dir] [--csv] [Files...]
+//
+//sizes go from 1K to 500M, --full runs all of them, --quick only the smallest ones for a smoke run.
+//allocs and alloc MB are counted for one run of an operation, peak MB is the largest amount of
+//memory allocated during that run above what was allocated before it, RSS MB is the peak of the process
+
+#include <Xml.h>
+#include <Utils/FileGuard.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+struct AllocationStats
+{
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> bytes;
+    std::atomic<int64_t> live;
+    std::atomic<int64_t> peak;
+};
+
+static AllocationStats allocationStats;
+
+//size is kept before the block, so frees are counted too
+const size_t ALLOCATION_HEADER = 16;
+
+static void *allocate_counted(size_t Size)
+{
+    char *block = static_cast<char*>(malloc(Size + ALLOCATION_HEADER));
+    if(!block)
+        throw std::bad_alloc();
+
+    *reinterpret_cast<size_t*>(block) = Size;
+
+    allocationStats.count++;
+    allocationStats.bytes += Size;
+
+    int64_t live = allocationStats.live += (int64_t)Size;
+    int64_t peak = allocationStats.peak;
+    while(live > peak && !allocationStats.peak.compare_exchange_weak(peak, live));
+
+    return block + ALLOCATION_HEADER;
+}
+
+static void free_counted(void *Pointer)
+{
+    if(!Pointer)
+        return;
+
+    char *block = static_cast<char*>(Pointer) - ALLOCATION_HEADER;
+    allocationStats.live -= (int64_t)*reinterpret_cast<size_t*>(block);
+
+    free(block);
+}
+
+void *operator new(size_t Size) {return allocate_counted(Size);}
+void *operator new[](size_t Size) {return allocate_counted(Size);}
+void operator delete(void *Pointer) throw() {free_counted(Pointer);}
+void operator delete[](void *Pointer) throw() {free_counted(Pointer);}
+
+static double get_peak_rss()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0.0;
+
+    return (double)counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage))
+        return 0.0;
+
+    return usage.ru_maxrss * 1024.0;
+#endif
+}
+
+enum DocumentKind
+{
+    DOCUMENT_KIND_DEEP,
+    DOCUMENT_KIND_WIDE,
+    DOCUMENT_KIND_ATTRIBUTES,
+    DOCUMENT_KIND_TEXT
+};
+
+static const char *get_kind_name(DocumentKind Kind)
+{
+    switch(Kind){
+    case DOCUMENT_KIND_DEEP:
+        return "deep";
+    case DOCUMENT_KIND_WIDE:
+        return "wide";
+    case DOCUMENT_KIND_ATTRIBUTES:
+        return "attributes";
+    default:
+        return "text";
+    }
+}
+
+//every kind has target nodes, so searches find something at any size
+static void append_block(std::string &Document, DocumentKind Kind, size_t Index)
+{
+    const char *words[] = {"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit"};
+
+    std::string index = Utils::ToString(Index);
+    bool target = Index % 16 == 0;
+
+    switch(Kind){
+    case DOCUMENT_KIND_DEEP:
+        for(int d = 0; d < 32; d++)
+            Document += "<node depth=\"" + Utils::ToString(d) + "\">";
+
+        Document += target ? "<target id=\"" + index + "\"/>" : "<leaf id=\"" + index + "\"/>";
+
+        for(int d = 0; d < 32; d++)
+            Document += "</node>";
+
+        Document += '\n';
+        break;
+    case DOCUMENT_KIND_WIDE:
+        Document += std::string(target ? "<target" : "<item") + " id=\"" + index + "\" value=\"" + index + "\"/>\n";
+        break;
+    case DOCUMENT_KIND_ATTRIBUTES:
+        Document += target ? "<target" : "<item";
+        for(int a = 0; a < 16; a++)
+            Document += " attribute" + Utils::ToString(a) + "=\"" + words[(Index + a) % 8] + index + "\"";
+
+        Document += "/>\n";
+        break;
+    default:
+        Document += target ? "<target>" : "<item>";
+        for(int w = 0; w < 128; w++){
+            Document += words[(Index + w) % 8];
+            Document += ' ';
+        }
+
+        Document += target ? "</target>\n" : "</item>\n";
+        break;
+    }
+}
+
+static std::string generate_document(DocumentKind Kind, size_t Size)
+{
+    std::string document = "<?xml version=\"1.0\"?>\n<benchmark kind=\"";
+    document += get_kind_name(Kind);
+    document += "\">\n";
+
+    const std::string closing = "</benchmark>\n";
+
+    document.reserve(Size + 4096);
+
+    for(size_t b = 0; document.size() + closing.size() < Size || !b; b++)
+        append_block(document, Kind, b);
+
+    document += closing;
+
+    return document;
+}
+
+static size_t parse_size(const std::string &Size)
+{
+    char *suffix = NULL;
+    double value = strtod(Size.c_str(), &suffix);
+
+    switch(*suffix){
+    case 'k':
+    case 'K':
+        value *= 1024.0;
+        break;
+    case 'm':
+    case 'M':
+        value *= 1024.0 * 1024.0;
+        break;
+    case 'g':
+    case 'G':
+        value *= 1024.0 * 1024.0 * 1024.0;
+        break;
+    }
+
+    return (size_t)value;
+}
+
+static std::string format_size(size_t Size)
+{
+    if(Size >= 1024 * 1024)
+        return Utils::ToString(Size / (1024 * 1024)) + "M";
+
+    if(Size >= 1024)
+        return Utils::ToString(Size / 1024) + "K";
+
+    return Utils::ToString(Size);
+}
+
+static std::string read_file(const std::string &FilePath)
+{
+    Utils::FileGuard file(FilePath, "rb");
+
+    std::string data;
+    char block[64 * 1024];
+    size_t nRead;
+    while((nRead = fread(block, 1, sizeof(block), file)) > 0)
+        data.append(block, nRead);
+
+    return data;
+}
+
+static void write_file(const std::string &FilePath, const std::string &Data)
+{
+    Utils::FileGuard file(FilePath, "wb");
+    if(fwrite(Data.data(), 1, Data.size(), file) != Data.size())
+        throw IOException("cant write to file " + FilePath);
+}
+
+//keeps results alive, so walks and searches cant be optimized away
+static volatile size_t sink;
+
+static size_t walk(const XML::Node &Root)
+{
+    size_t visited = Root.GetName().size() + Root.GetValue().size();
+
+    XML::ConstNodeIterator it;
+    for(it = Root.begin(); it != Root.end(); ++it)
+        visited += walk(*it);
+
+    return visited + 1;
+}
+
+struct BenchmarkOptions
+{
+    std::vector<size_t> sizes;
+    std::vector<std::string> files;
+    std::string tmpDir;
+    double minTime;
+    bool csv;
+    BenchmarkOptions() : tmpDir("."), minTime(0.5), csv(false){}
+};
+
+class Benchmark final
+{
+private:
+    typedef std::chrono::high_resolution_clock Clock;
+    const BenchmarkOptions &options;
+    std::string document;
+    size_t size;
+    void Report(const std::string &Operation, double Seconds, uint64_t Allocations, uint64_t AllocatedBytes, int64_t PeakBytes) const;
+public:
+    Benchmark(const Benchmark &) = delete;
+    Benchmark &operator= (const Benchmark &) = delete;
+    Benchmark(const BenchmarkOptions &Options, const std::string &Document, size_t Size) :
+        options(Options), document(Document), size(Size){}
+    template<class TPrepare, class TRun, class TFinish>
+    void Run(const std::string &Operation, TPrepare Prepare, TRun Run, TFinish Finish);
+    template<class TRun>
+    void Run(const std::string &Operation, TRun Run)
+    {
+        this->Run(Operation, [](){}, Run, [](){});
+    }
+    static void PrintHeader(const BenchmarkOptions &Options);
+};
+
+void Benchmark::PrintHeader(const BenchmarkOptions &Options)
+{
+    if(Options.csv){
+        std::cout << "document,size,operation,MB/s,allocs,alloc MB,peak MB,RSS MB" << std::endl;
+        return;
+    }
+
+    char line[256];
+    sprintf(line, "%-28s %8s  %-22s %10s %12s %10s %10s %10s",
+            "document", "size", "operation", "MB/s", "allocs", "alloc MB", "peak MB", "RSS MB");
+    std::cout << line << std::endl;
+}
+
+void Benchmark::Report(const std::string &Operation, double Seconds, uint64_t Allocations, uint64_t AllocatedBytes, int64_t PeakBytes) const
+{
+    const double megabyte = 1024.0 * 1024.0;
+
+    double throughput = Seconds > 0.0 ? size / megabyte / Seconds : 0.0;
+    double allocated = AllocatedBytes / megabyte, peak = PeakBytes / megabyte, rss = get_peak_rss() / megabyte;
+
+    char line[512];
+    if(options.csv)
+        sprintf(line, "%s,%u,%s,%.2f,%llu,%.3f,%.3f,%.1f",
+                document.c_str(), (unsigned)size, Operation.c_str(), throughput, (unsigned long long)Allocations, allocated, peak, rss);
+    else
+        sprintf(line, "%-28s %8s  %-22s %10.2f %12llu %10.3f %10.3f %10.1f",
+                document.c_str(), format_size(size).c_str(), Operation.c_str(), throughput, (unsigned long long)Allocations, allocated, peak, rss);
+
+    std::cout << line << std::endl;
+}
+
+template<class TPrepare, class TRun, class TFinish>
+void Benchmark::Run(const std::string &Operation, TPrepare Prepare, TRun Run, TFinish Finish)
+{
+    //first run is measured for memory, all runs for time
+    double total = 0.0;
+    size_t runs = 0;
+    uint64_t allocations = 0, allocatedBytes = 0;
+    int64_t peakBytes = 0;
+
+    for(size_t r = 0; r == 0 || (total < options.minTime && r < 1000); r++){
+        Prepare();
+
+        uint64_t count = allocationStats.count, bytes = allocationStats.bytes;
+        int64_t live = allocationStats.live;
+        allocationStats.peak = live;
+
+        Clock::time_point start = Clock::now();
+        Run();
+        Clock::time_point finish = Clock::now();
+
+        if(r == 0){
+            allocations = allocationStats.count - count;
+            allocatedBytes = allocationStats.bytes - bytes;
+            peakBytes = allocationStats.peak - live;
+        }
+
+        Finish();
+
+        total += std::chrono::duration<double>(finish - start).count();
+        runs++;
+    }
+
+    Report(Operation, total / runs, allocations, allocatedBytes, peakBytes);
+}
+
+static void run_document(const BenchmarkOptions &Options, const std::string &Name, const std::string &Data)
+{
+    Benchmark benchmark(Options, Name, Data.size());
+
+    std::string filePath = Options.tmpDir + "/xml_benchmark.xml";
+    std::string savePath = Options.tmpDir + "/xml_benchmark_saved.xml";
+    write_file(filePath, Data);
+
+    benchmark.Run("LoadFromString", [&](){
+        XML::XmlData data;
+        data.LoadFromString(Data);
+    });
+
+    benchmark.Run("LoadFromString arena", [&](){
+        XML::XmlData data(XML::XmlData::STORAGE_MODE_ARENA);
+        data.LoadFromString(Data);
+    });
+
+    const XML::LoadMode modes[] = {XML::LOAD_MODE_BUFFERED, XML::LOAD_MODE_MAPPED, XML::LOAD_MODE_PARALLEL, XML::LOAD_MODE_LAZY};
+    const char *modesNames[] = {"LoadFromFile buffered", "LoadFromFile mapped", "LoadFromFile parallel", "LoadFromFile lazy"};
+
+    //binary cache is on by default, it would hide the parsing
+    for(int m = 0; m < 4; m++)
+        benchmark.Run(modesNames[m], [&](){
+            XML::XmlData data;
+            data.SetCacheMode(XML::XmlData::CACHE_MODE_NONE);
+            data.LoadFromFile(filePath, modes[m]);
+        });
+
+    benchmark.Run("LoadFromFile lazy walk", [&](){
+        XML::XmlData data;
+        data.SetCacheMode(XML::XmlData::CACHE_MODE_NONE);
+        data.LoadFromFile(filePath, XML::LOAD_MODE_LAZY);
+        sink = walk(data.GetRoot());
+    });
+
+    //cache is written once, then only read
+    std::string cachePath = XML::XmlData::GetCachePath(filePath);
+    {
+        XML::XmlData data;
+        data.SetCacheMode(XML::XmlData::CACHE_MODE_BINARY);
+        data.LoadFromFile(filePath);
+    }
+
+    benchmark.Run("LoadFromFile cached", [&](){
+        XML::XmlData data;
+        data.SetCacheMode(XML::XmlData::CACHE_MODE_BINARY);
+        data.LoadFromFile(filePath);
+    });
+
+    remove(cachePath.c_str());
+
+    XML::XmlData data;
+    data.LoadFromString(Data);
+    const XML::XmlData &constData = data;
+
+    benchmark.Run("FindNode", [&](){
+        XML::ConstNodesSet nodes;
+        constData.GetRoot().FindNode("target", nodes);
+        sink = nodes.size();
+    });
+
+    benchmark.Run("iteration", [&](){
+        sink = walk(constData.GetRoot());
+    });
+
+    benchmark.Run("ToString", [&](){
+        sink = data.ToString().size();
+    });
+
+    benchmark.Run("SaveToFile", [](){}, [&](){
+        data.SaveToFile(savePath);
+    }, [&](){
+        remove(savePath.c_str());
+    });
+
+    remove(filePath.c_str());
+}
+
+static std::string get_file_name(const std::string &FilePath)
+{
+    size_t slash = FilePath.find_last_of("/\\");
+    return slash == std::string::npos ? FilePath : FilePath.substr(slash + 1);
+}
+
+static void parse_sizes(const std::string &Sizes, std::vector<size_t> &Result)
+{
+    Result.clear();
+
+    std::istringstream stream(Sizes);
+    std::string size;
+    while(std::getline(stream, size, ','))
+        if(size.size())
+            Result.push_back(parse_size(size));
+}
+
+int main(int argc, char *argv[])
+{
+    BenchmarkOptions options;
+    parse_sizes("1K,64K,1M,16M", options.sizes);
+
+    for(int a = 1; a < argc; a++){
+        std::string arg = argv[a];
+
+        if(arg == "--full")
+            parse_sizes("1K,64K,1M,16M,128M,500M", options.sizes);
+        else if(arg == "--quick"){
+            parse_sizes("1K,64K", options.sizes);
+            options.minTime = 0.0;
+        }else if(arg == "--sizes" && a + 1 < argc)
+            parse_sizes(argv[++a], options.sizes);
+        else if(arg == "--time" && a + 1 < argc)
+            options.minTime = strtod(argv[++a], NULL);
+        else if(arg == "--tmp" && a + 1 < argc)
+            options.tmpDir = argv[++a];
+        else if(arg == "--csv")
+            options.csv = true;
+        else if(arg.size() && arg[0] == '-'){
+            std::cerr << "usage: XmlBenchmark [--sizes 1K,64K,1M] [--full] [--quick] [--time Seconds] [--tmp Dir] [--csv] [Files...]" << std::endl;
+            return 1;
+        }else
+            options.files.push_back(arg);
+    }
+
+    try{
+        Benchmark::PrintHeader(options);
+
+        const DocumentKind kinds[] = {DOCUMENT_KIND_DEEP, DOCUMENT_KIND_WIDE, DOCUMENT_KIND_ATTRIBUTES, DOCUMENT_KIND_TEXT};
+
+        for(size_t s = 0; s < options.sizes.size(); s++)
+            for(int k = 0; k < 4; k++){
+                std::string document = generate_document(kinds[k], options.sizes[s]);
+                run_document(options, get_kind_name(kinds[k]), document);
+            }
+
+        for(size_t f = 0; f < options.files.size(); f++)
+            run_document(options, get_file_name(options.files[f]), read_file(options.files[f]));
+
+    }catch(const Exception &ex){
+        std::cerr << ex.What() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file